@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *
+ * @brief ZBOSS memory configuration of the coop.
+ *
+ * Replaces the generic zb_mem_config_med.h. Defines the storage of the
+ * stack, so it must be included by exactly one source file.
+ */
+
+#ifndef ZB_MEM_CONFIG_COOP_H
+#define ZB_MEM_CONFIG_COOP_H
+
+#ifdef CONFIG_ZIGBEE_ROLE_END_DEVICE
+
+/* The sleepy coop only talks to its parent and a few bound clients. */
+#define ZB_CONFIG_ROLE_ZED
+#define ZB_CONFIG_OVERALL_NETWORK_SIZE 16
+#define ZB_CONFIG_LIGHT_TRAFFIC
+#define ZB_CONFIG_APPLICATION_SIMPLE
+
+#include "zb_mem_config_common.h"
+
+#else
+
+/* A mains powered coop is the router of the sensors around the yard, most of
+ * them sleepy children. Routing capacity stays at the level of the generic
+ * zb_mem_config_med.h until measured traffic and a RAM report show what can
+ * go. Only the coordinator role is dropped.
+ */
+#define ZB_CONFIG_ROLE_ZR
+#define ZB_CONFIG_OVERALL_NETWORK_SIZE 128
+#define ZB_CONFIG_HIGH_TRAFFIC
+#define ZB_CONFIG_APPLICATION_COMPLEX
+
+#include "zb_mem_config_common.h"
+
+#endif
+
+#include "zb_mem_config_context.h"
+
+#endif /* ZB_MEM_CONFIG_COOP_H */
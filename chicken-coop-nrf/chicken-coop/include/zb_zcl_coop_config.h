@@ -0,0 +1,289 @@
+#ifndef ZB_ZCL_COOP_CONFIG_H
+#define ZB_ZCL_COOP_CONFIG_H
+
+/**
+ *  @defgroup ZB_ZCL_COOP_CONFIG Coop configuration cluster
+ *  @{
+ *  @details
+ *      Manufacturer-specific cluster exposing the runtime motion
+ *      configuration of the coop door, its state, the sun schedule and the
+ *      light levels driving the door.
+ *      Written values are persisted with the settings subsystem, as is
+ *      the result of the calibrate command.
+ */
+
+/** Coop configuration cluster ID, from the manufacturer-specific range */
+#define ZB_ZCL_CLUSTER_ID_COOP_CONFIG 0xFC00U
+
+/** Manufacturer code of the cluster and of all of its attributes */
+#define ZB_ZCL_COOP_CONFIG_MANUF_CODE ((zb_uint16_t)CONFIG_CHICKEN_COOP_MANUF_CODE)
+
+/** Coop configuration cluster revision */
+#define ZB_ZCL_COOP_CONFIG_CLUSTER_REVISION_DEFAULT ((zb_uint16_t)0x0001u)
+
+/** Coop configuration cluster attribute identifiers */
+enum zb_zcl_coop_config_attr_e {
+	/** Steps between the closed and the open position */
+	ZB_ZCL_ATTR_COOP_CONFIG_TRAVEL_STEPS_ID = 0x0000,
+	/** Cruise speed in steps/s */
+	ZB_ZCL_ATTR_COOP_CONFIG_CRUISE_SPEED_ID = 0x0001,
+	/** Acceleration in steps/s^2 */
+	ZB_ZCL_ATTR_COOP_CONFIG_ACCELERATION_ID = 0x0002,
+	/** Time the motor holds the door after a move, in ms */
+	ZB_ZCL_ATTR_COOP_CONFIG_HOLD_TIMEOUT_ID = 0x0003,
+	/** Door state, read only and reportable, see @ref zb_zcl_coop_config_door_state_e */
+	ZB_ZCL_ATTR_COOP_CONFIG_DOOR_STATE_ID = 0x0010,
+	/** Steps the encoder measured minus steps generated over the last move, read only */
+	ZB_ZCL_ATTR_COOP_CONFIG_POSITION_ERROR_ID = 0x0011,
+	/** Whether the door opens at sunrise and closes at sunset */
+	ZB_ZCL_ATTR_COOP_CONFIG_SCHEDULE_ENABLED_ID = 0x0020,
+	/** Latitude in 0.01 deg, north positive */
+	ZB_ZCL_ATTR_COOP_CONFIG_LATITUDE_ID = 0x0021,
+	/** Longitude in 0.01 deg, east positive */
+	ZB_ZCL_ATTR_COOP_CONFIG_LONGITUDE_ID = 0x0022,
+	/** Opening time relative to sunrise, in minutes */
+	ZB_ZCL_ATTR_COOP_CONFIG_SUNRISE_OFFSET_ID = 0x0023,
+	/** Closing time relative to sunset, in minutes */
+	ZB_ZCL_ATTR_COOP_CONFIG_SUNSET_OFFSET_ID = 0x0024,
+	/** Whether the door opens at dawn and closes at dusk, measured locally */
+	ZB_ZCL_ATTR_COOP_CONFIG_LIGHT_CONTROL_ID = 0x0030,
+	/** Illuminance at or above which the door opens, in ZCL illuminance units */
+	ZB_ZCL_ATTR_COOP_CONFIG_DAWN_LEVEL_ID = 0x0031,
+	/** Illuminance at or below which the door closes, in ZCL illuminance units */
+	ZB_ZCL_ATTR_COOP_CONFIG_DUSK_LEVEL_ID = 0x0032,
+	/** Time from reset to joined at the last boot in ms, read only */
+	ZB_ZCL_ATTR_COOP_CONFIG_BOOT_TIME_ID = 0x0040,
+	/** 99th percentile of the step timing error over the last move in us, read only */
+	ZB_ZCL_ATTR_COOP_CONFIG_STEP_JITTER_ID = 0x0041,
+};
+
+/** Coop configuration cluster commands received by the server */
+enum zb_zcl_coop_config_cmd_e {
+	/** Measure the travel and the fastest reliable cruise speed, no payload */
+	ZB_ZCL_CMD_COOP_CONFIG_CALIBRATE_ID = 0x00,
+};
+
+/** Values of the door state attribute */
+enum zb_zcl_coop_config_door_state_e {
+	ZB_ZCL_COOP_CONFIG_DOOR_STATE_CLOSED = 0x00,
+	ZB_ZCL_COOP_CONFIG_DOOR_STATE_OPENING = 0x01,
+	ZB_ZCL_COOP_CONFIG_DOOR_STATE_OPEN = 0x02,
+	ZB_ZCL_COOP_CONFIG_DOOR_STATE_CLOSING = 0x03,
+	ZB_ZCL_COOP_CONFIG_DOOR_STATE_STOPPED = 0x04,
+	ZB_ZCL_COOP_CONFIG_DOOR_STATE_FAULT = 0x05,
+};
+
+/** Alarm codes raised through the Alarms cluster, with this cluster as cluster ID */
+enum zb_zcl_coop_config_alarm_e {
+	/** The door was blocked while closing */
+	ZB_ZCL_COOP_CONFIG_ALARM_OBSTRUCTED = 0x01,
+	/** The motor stalled while opening */
+	ZB_ZCL_COOP_CONFIG_ALARM_STALLED = 0x02,
+	/** The encoder measured more lost steps than the drift limit */
+	ZB_ZCL_COOP_CONFIG_ALARM_DRIFT = 0x03,
+};
+
+/** Number of reportable attributes of the cluster */
+#define ZB_ZCL_COOP_CONFIG_REPORT_ATTR_COUNT 1
+
+/** @cond internals_doc */
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_TRAVEL_STEPS_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_TRAVEL_STEPS_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_CRUISE_SPEED_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_CRUISE_SPEED_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_ACCELERATION_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_ACCELERATION_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U32,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_HOLD_TIMEOUT_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_HOLD_TIMEOUT_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_DOOR_STATE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_DOOR_STATE_ID,				   \
+	ZB_ZCL_ATTR_TYPE_8BIT_ENUM,					   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_ACCESS_REPORTING |	   \
+		ZB_ZCL_ATTR_MANUF_SPEC,					   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_POSITION_ERROR_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_POSITION_ERROR_ID,			   \
+	ZB_ZCL_ATTR_TYPE_S16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_SCHEDULE_ENABLED_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_SCHEDULE_ENABLED_ID,			   \
+	ZB_ZCL_ATTR_TYPE_BOOL,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_LATITUDE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_LATITUDE_ID,				   \
+	ZB_ZCL_ATTR_TYPE_S16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_LONGITUDE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_LONGITUDE_ID,				   \
+	ZB_ZCL_ATTR_TYPE_S16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_SUNRISE_OFFSET_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_SUNRISE_OFFSET_ID,			   \
+	ZB_ZCL_ATTR_TYPE_S16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_SUNSET_OFFSET_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_SUNSET_OFFSET_ID,			   \
+	ZB_ZCL_ATTR_TYPE_S16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_LIGHT_CONTROL_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_LIGHT_CONTROL_ID,			   \
+	ZB_ZCL_ATTR_TYPE_BOOL,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_DAWN_LEVEL_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_DAWN_LEVEL_ID,				   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_DUSK_LEVEL_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_DUSK_LEVEL_ID,				   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_BOOT_TIME_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_BOOT_TIME_ID,				   \
+	ZB_ZCL_ATTR_TYPE_U32,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_CONFIG_STEP_JITTER_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_CONFIG_STEP_JITTER_ID,				   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_CONFIG_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+/** Registers the handlers of the cluster, called by ZBOSS when the endpoint is registered */
+void zb_zcl_coop_config_init_server(void);
+
+#define ZB_ZCL_CLUSTER_ID_COOP_CONFIG_SERVER_ROLE_INIT zb_zcl_coop_config_init_server
+#define ZB_ZCL_CLUSTER_ID_COOP_CONFIG_CLIENT_ROLE_INIT ((zb_zcl_cluster_init_t)NULL)
+
+/** @endcond */ /* internals_doc */
+
+/**
+ * @brief Declare attribute list for Coop configuration cluster
+ * @param attr_list - attribute list name
+ * @param travel_steps - pointer to variable to store travel steps attribute
+ * @param cruise_speed - pointer to variable to store cruise speed attribute
+ * @param acceleration - pointer to variable to store acceleration attribute
+ * @param hold_timeout - pointer to variable to store hold timeout attribute
+ * @param door_state - pointer to variable to store door state attribute
+ * @param position_error - pointer to variable to store position error attribute
+ * @param schedule_enabled - pointer to variable to store schedule enabled attribute
+ * @param latitude - pointer to variable to store latitude attribute
+ * @param longitude - pointer to variable to store longitude attribute
+ * @param sunrise_offset - pointer to variable to store sunrise offset attribute
+ * @param sunset_offset - pointer to variable to store sunset offset attribute
+ * @param light_control - pointer to variable to store light control attribute
+ * @param dawn_level - pointer to variable to store dawn level attribute
+ * @param dusk_level - pointer to variable to store dusk level attribute
+ * @param boot_time - pointer to variable to store boot time attribute
+ * @param step_jitter - pointer to variable to store step jitter attribute
+ */
+#define ZB_ZCL_DECLARE_COOP_CONFIG_ATTRIB_LIST(attr_list, travel_steps,		   \
+	cruise_speed, acceleration, hold_timeout, door_state, position_error,	   \
+	schedule_enabled, latitude, longitude, sunrise_offset, sunset_offset,	   \
+	light_control, dawn_level, dusk_level, boot_time, step_jitter)		   \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_COOP_CONFIG) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_TRAVEL_STEPS_ID, (travel_steps)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_CRUISE_SPEED_ID, (cruise_speed)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_ACCELERATION_ID, (acceleration)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_HOLD_TIMEOUT_ID, (hold_timeout)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_DOOR_STATE_ID, (door_state))   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_POSITION_ERROR_ID, (position_error)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_SCHEDULE_ENABLED_ID, (schedule_enabled)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_LATITUDE_ID, (latitude))	   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_LONGITUDE_ID, (longitude))	   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_SUNRISE_OFFSET_ID, (sunrise_offset)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_SUNSET_OFFSET_ID, (sunset_offset)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_LIGHT_CONTROL_ID, (light_control)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_DAWN_LEVEL_ID, (dawn_level))   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_DUSK_LEVEL_ID, (dusk_level))   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_BOOT_TIME_ID, (boot_time))	   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_CONFIG_STEP_JITTER_ID, (step_jitter)) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+/** @} */
+
+#endif /* ZB_ZCL_COOP_CONFIG_H */
@@ -0,0 +1,214 @@
+#ifndef ZB_ZCL_COOP_DIAGNOSTICS_H
+#define ZB_ZCL_COOP_DIAGNOSTICS_H
+
+/**
+ *  @defgroup ZB_ZCL_COOP_DIAGNOSTICS Diagnostics cluster
+ *  @{
+ *  @details
+ *      Diagnostics cluster of the coop, with the CPU share and the unused
+ *      stack of its threads, the heap peak and how often the ZBOSS buffer
+ *      pool ran low. The attributes are vendor attributes of the standard
+ *      cluster, flagged manufacturer-specific with
+ *      CONFIG_CHICKEN_COOP_MANUF_CODE so that they do not clash with
+ *      another vendor's, a read has to carry the same code. All are read
+ *      only and refreshed every CONFIG_CHICKEN_COOP_DIAG_PERIOD seconds, a
+ *      read returns values up to that old.
+ */
+
+/** Diagnostics cluster ID, the standard one */
+#define ZB_ZCL_CLUSTER_ID_COOP_DIAGNOSTICS ZB_ZCL_CLUSTER_ID_DIAGNOSTICS
+
+/** Manufacturer code of the coop attributes, the same as the coop configuration cluster */
+#define ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE ((zb_uint16_t)CONFIG_CHICKEN_COOP_MANUF_CODE)
+
+/** Diagnostics cluster revision */
+#define ZB_ZCL_COOP_DIAGNOSTICS_CLUSTER_REVISION_DEFAULT ((zb_uint16_t)0x0001u)
+
+/** Diagnostics cluster attribute identifiers
+ *
+ * CPU shares are averaged since boot in 0.01 %, unused stack is the least
+ * free since boot in bytes.
+ */
+enum zb_zcl_coop_diagnostics_attr_e {
+	/** CPU share of all threads but the idle thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_CPU_LOAD_ID = 0xE000,
+	/** CPU share of the main thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_CPU_ID = 0xE010,
+	/** Unused stack of the main thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_STACK_FREE_ID = 0xE011,
+	/** CPU share of the Zigbee thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_CPU_ID = 0xE020,
+	/** Unused stack of the Zigbee thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_STACK_FREE_ID = 0xE021,
+	/** CPU share of the motion thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_CPU_ID = 0xE030,
+	/** Unused stack of the motion thread */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_STACK_FREE_ID = 0xE031,
+	/** CPU share of the system workqueue */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_CPU_ID = 0xE040,
+	/** Unused stack of the system workqueue */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_STACK_FREE_ID = 0xE041,
+	/** Most heap in use at once since boot, in bytes */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_HEAP_PEAK_ID = 0xE050,
+	/** Times the ZBOSS buffer pool was seen running low since boot */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_LOW_ID = 0xE060,
+	/** Times the ZBOSS buffer pool was seen out of buffers since boot */
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_OOM_ID = 0xE061,
+};
+
+/** @cond internals_doc */
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_CPU_LOAD_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_CPU_LOAD_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_CPU_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_CPU_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_STACK_FREE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_STACK_FREE_ID,		   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_CPU_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_CPU_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_STACK_FREE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_STACK_FREE_ID,		   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_CPU_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_CPU_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_STACK_FREE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_STACK_FREE_ID,		   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_CPU_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_CPU_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_STACK_FREE_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_STACK_FREE_ID,		   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_HEAP_PEAK_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_HEAP_PEAK_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U32,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_LOW_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_LOW_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+#define ZB_SET_ATTR_DESCR_WITH_ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_OOM_ID(data_ptr) \
+{									   \
+	ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_OOM_ID,			   \
+	ZB_ZCL_ATTR_TYPE_U16,						   \
+	ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC,		   \
+	(ZB_ZCL_COOP_DIAGNOSTICS_MANUF_CODE),				   \
+	(void *) data_ptr						   \
+}
+
+/** Registers the cluster with ZBOSS, called when the endpoint is registered */
+void zb_zcl_coop_diagnostics_init_server(void);
+
+#define ZB_ZCL_CLUSTER_ID_COOP_DIAGNOSTICS_SERVER_ROLE_INIT zb_zcl_coop_diagnostics_init_server
+#define ZB_ZCL_CLUSTER_ID_COOP_DIAGNOSTICS_CLIENT_ROLE_INIT ((zb_zcl_cluster_init_t)NULL)
+
+/** @endcond */ /* internals_doc */
+
+/**
+ * @brief Declare attribute list for Diagnostics cluster
+ * @param attr_list - attribute list name
+ * @param cpu_load - pointer to variable to store CPU load attribute
+ * @param main_cpu - pointer to variable to store main thread CPU share attribute
+ * @param main_stack_free - pointer to variable to store main thread unused stack attribute
+ * @param zigbee_cpu - pointer to variable to store Zigbee thread CPU share attribute
+ * @param zigbee_stack_free - pointer to variable to store Zigbee thread unused stack attribute
+ * @param motion_cpu - pointer to variable to store motion thread CPU share attribute
+ * @param motion_stack_free - pointer to variable to store motion thread unused stack attribute
+ * @param workq_cpu - pointer to variable to store workqueue CPU share attribute
+ * @param workq_stack_free - pointer to variable to store workqueue unused stack attribute
+ * @param heap_peak - pointer to variable to store heap peak attribute
+ * @param buf_low - pointer to variable to store buffer pool low attribute
+ * @param buf_oom - pointer to variable to store buffer pool out of buffers attribute
+ */
+#define ZB_ZCL_DECLARE_COOP_DIAGNOSTICS_ATTRIB_LIST(attr_list, cpu_load,	   \
+		main_cpu, main_stack_free, zigbee_cpu, zigbee_stack_free,	   \
+		motion_cpu, motion_stack_free, workq_cpu, workq_stack_free,	   \
+		heap_peak, buf_low, buf_oom)					   \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_COOP_DIAGNOSTICS) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_CPU_LOAD_ID, (cpu_load)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_CPU_ID, (main_cpu)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MAIN_STACK_FREE_ID, (main_stack_free)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_CPU_ID, (zigbee_cpu)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_ZIGBEE_STACK_FREE_ID, (zigbee_stack_free)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_CPU_ID, (motion_cpu)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_MOTION_STACK_FREE_ID, (motion_stack_free)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_CPU_ID, (workq_cpu)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_WORKQ_STACK_FREE_ID, (workq_stack_free)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_HEAP_PEAK_ID, (heap_peak)) \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_LOW_ID, (buf_low))   \
+	ZB_ZCL_SET_ATTR_DESC(ZB_ZCL_ATTR_COOP_DIAGNOSTICS_BUF_OOM_ID, (buf_oom))   \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+/** @} */
+
+#endif /* ZB_ZCL_COOP_DIAGNOSTICS_H */
@@ -6,6 +6,11 @@
 #ifndef ZIGBEE_H
 #define ZIGBEE_H
 
+#include <zephyr/sys/util.h>
+
+#include "zb_zcl_coop_config.h"
+#include "zb_zcl_coop_diagnostics.h"
+
 /**
  *  @defgroup ZB_DEFINE_DEVICE_CHICKEN_COOP Dimmable Light
  *  @{
@@ -15,7 +20,13 @@
  *      - @ref ZB_ZCL_SCENES \n
  *      - @ref ZB_ZCL_GROUPS \n
  *      - @ref ZB_ZCL_ON_OFF \n
- *      - @ref ZB_ZCL_LEVEL_CONTROL
+ *      - @ref ZB_ZCL_WINDOW_COVERING \n
+ *      - @ref ZB_ZCL_COOP_CONFIG \n
+ *      - @ref ZB_ZCL_ILLUMINANCE_MEASUREMENT \n
+ *      - @ref ZB_ZCL_ALARMS \n
+ *      - @ref ZB_ZCL_POLL_CONTROL (sleepy end device only) \n
+ *      - @ref ZB_ZCL_COOP_DIAGNOSTICS (with CONFIG_CHICKEN_COOP_DIAG) \n
+ *      - @ref ZB_ZCL_TIME (client)
  */
 
 /** Dimmable Light Device ID */
@@ -26,11 +37,82 @@
 
 /** @cond internals_doc */
 
+/* The sleepy end device variant adds a Poll Control server to the endpoint. */
+#ifdef CONFIG_CHICKEN_COOP_SLEEPY
+#define ZB_CHICKEN_COOP_POLL_CONTROL_CLUSTER(X)					   \
+	X(ZB_ZCL_CLUSTER_ID_POLL_CONTROL, poll_control_attr_list)
+#else
+#define ZB_CHICKEN_COOP_POLL_CONTROL_CLUSTER(X)
+#endif
+
+#ifdef CONFIG_CHICKEN_COOP_DIAG
+#define ZB_CHICKEN_COOP_DIAGNOSTICS_CLUSTER(X)					   \
+	X(ZB_ZCL_CLUSTER_ID_COOP_DIAGNOSTICS, diagnostics_attr_list)
+#else
+#define ZB_CHICKEN_COOP_DIAGNOSTICS_CLUSTER(X)
+#endif
+
+/* The clusters of the endpoint, everything else is derived from these lists.
+ * Server clusters as X(cluster ID, attribute list), followed by the
+ * manufacturer code for manufacturer-specific clusters. Client ones as
+ * X(cluster ID).
+ */
+#define ZB_CHICKEN_COOP_IN_CLUSTERS(X)						   \
+	X(ZB_ZCL_CLUSTER_ID_BASIC, basic_attr_list)				   \
+	X(ZB_ZCL_CLUSTER_ID_IDENTIFY, identify_attr_list)			   \
+	X(ZB_ZCL_CLUSTER_ID_SCENES, scenes_attr_list)				   \
+	X(ZB_ZCL_CLUSTER_ID_GROUPS, groups_attr_list)				   \
+	X(ZB_ZCL_CLUSTER_ID_ON_OFF, on_off_attr_list)				   \
+	X(ZB_ZCL_CLUSTER_ID_WINDOW_COVERING, window_covering_attr_list)		   \
+	X(ZB_ZCL_CLUSTER_ID_COOP_CONFIG, coop_config_attr_list,			   \
+	  ZB_ZCL_COOP_CONFIG_MANUF_CODE)					   \
+	X(ZB_ZCL_CLUSTER_ID_ILLUMINANCE_MEASUREMENT, illuminance_attr_list)	   \
+	X(ZB_ZCL_CLUSTER_ID_ALARMS, alarms_attr_list)				   \
+	ZB_CHICKEN_COOP_POLL_CONTROL_CLUSTER(X)					   \
+	ZB_CHICKEN_COOP_DIAGNOSTICS_CLUSTER(X)
+
+#define ZB_CHICKEN_COOP_OUT_CLUSTERS(X)						   \
+	X(ZB_ZCL_CLUSTER_ID_TIME)
+
+#define ZB_CHICKEN_COOP_CLUSTER_ID(id, ...) id,
+#define ZB_CHICKEN_COOP_CLUSTER_ARG(...) , ~
+
+/* Spelled out instead of ZB_ZCL_CLUSTER_DESC, which pastes its cluster ID into
+ * the name of the init function. Passed on from here the ID would already be
+ * expanded to its number.
+ */
+#define ZB_CHICKEN_COOP_SERVER_CLUSTER_DESC(id, attr_list, ...)		   \
+	{									   \
+		(id),								   \
+		ZB_ZCL_ARRAY_SIZE(attr_list, zb_zcl_attr_t),			   \
+		(attr_list),							   \
+		ZB_ZCL_CLUSTER_SERVER_ROLE,					   \
+		COND_CODE_1(IS_EMPTY(__VA_ARGS__),				   \
+			    (ZB_ZCL_MANUF_CODE_INVALID), (__VA_ARGS__)),	   \
+		id##_SERVER_ROLE_INIT						   \
+	},
+
+#define ZB_CHICKEN_COOP_CLIENT_CLUSTER_DESC(id)					   \
+	{									   \
+		(id),								   \
+		0,								   \
+		NULL,								   \
+		ZB_ZCL_CLUSTER_CLIENT_ROLE,					   \
+		ZB_ZCL_MANUF_CODE_INVALID,					   \
+		id##_CLIENT_ROLE_INIT						   \
+	},
+
+/* ZBOSS pastes the cluster numbers into type names, they have to expand to
+ * a single number, not to an expression.
+ */
+
 /** Dimmable Light IN (server) clusters number */
-#define ZB_CHICKEN_COOP_IN_CLUSTER_NUM 6
+#define ZB_CHICKEN_COOP_IN_CLUSTER_NUM						   \
+	NUM_VA_ARGS_LESS_1(~ ZB_CHICKEN_COOP_IN_CLUSTERS(ZB_CHICKEN_COOP_CLUSTER_ARG))
 
 /** Dimmable Light OUT (client) clusters number */
-#define ZB_CHICKEN_COOP_OUT_CLUSTER_NUM 0
+#define ZB_CHICKEN_COOP_OUT_CLUSTER_NUM						   \
+	NUM_VA_ARGS_LESS_1(~ ZB_CHICKEN_COOP_OUT_CLUSTERS(ZB_CHICKEN_COOP_CLUSTER_ARG))
 
 /** Dimmable light total (IN+OUT) cluster number */
 #define ZB_CHICKEN_COOP_CLUSTER_NUM \
@@ -38,66 +120,26 @@
 
 /** Number of attribute for reporting on Dimmable Light device */
 #define ZB_CHICKEN_COOP_REPORT_ATTR_COUNT \
-	(ZB_ZCL_ON_OFF_REPORT_ATTR_COUNT + ZB_ZCL_LEVEL_CONTROL_REPORT_ATTR_COUNT)
-
-/** Continuous value change attribute count */
-#define ZB_CHICKEN_COOP_CVC_ATTR_COUNT 1
+	(ZB_ZCL_ON_OFF_REPORT_ATTR_COUNT + ZB_ZCL_WINDOW_COVERING_REPORT_ATTR_COUNT + \
+	 ZB_ZCL_COOP_CONFIG_REPORT_ATTR_COUNT + ZB_ZCL_ILLUMINANCE_MEASUREMENT_REPORT_ATTR_COUNT)
 
 /** @endcond */ /* internals_doc */
 
 /**
  * @brief Declare cluster list for Dimmable Light device
+ *
+ * Takes the attribute lists named in ZB_CHICKEN_COOP_IN_CLUSTERS, e.g.
+ * basic_attr_list for the Basic cluster. poll_control_attr_list is only
+ * needed by the sleepy end device variant, diagnostics_attr_list only with
+ * CONFIG_CHICKEN_COOP_DIAG.
+ *
  * @param cluster_list_name - cluster list variable name
- * @param basic_attr_list - attribute list for Basic cluster
- * @param identify_attr_list - attribute list for Identify cluster
- * @param groups_attr_list - attribute list for Groups cluster
- * @param scenes_attr_list - attribute list for Scenes cluster
- * @param on_off_attr_list - attribute list for On/Off cluster
  */
-#define ZB_DECLARE_CHICKEN_COOP_CLUSTER_LIST(					   \
-	cluster_list_name,							   \
-	basic_attr_list,							   \
-	identify_attr_list,							   \
-	groups_attr_list,							   \
-	scenes_attr_list,							   \
-	on_off_attr_list)						   \
+#define ZB_DECLARE_CHICKEN_COOP_CLUSTER_LIST(cluster_list_name)			   \
 	zb_zcl_cluster_desc_t cluster_list_name[] =				   \
 	{									   \
-		ZB_ZCL_CLUSTER_DESC(						   \
-			ZB_ZCL_CLUSTER_ID_IDENTIFY,				   \
-			ZB_ZCL_ARRAY_SIZE(identify_attr_list, zb_zcl_attr_t),	   \
-			(identify_attr_list),					   \
-			ZB_ZCL_CLUSTER_SERVER_ROLE,				   \
-			ZB_ZCL_MANUF_CODE_INVALID				   \
-		),								   \
-		ZB_ZCL_CLUSTER_DESC(						   \
-			ZB_ZCL_CLUSTER_ID_BASIC,				   \
-			ZB_ZCL_ARRAY_SIZE(basic_attr_list, zb_zcl_attr_t),	   \
-			(basic_attr_list),					   \
-			ZB_ZCL_CLUSTER_SERVER_ROLE,				   \
-			ZB_ZCL_MANUF_CODE_INVALID				   \
-		),								   \
-		ZB_ZCL_CLUSTER_DESC(						   \
-			ZB_ZCL_CLUSTER_ID_SCENES,				   \
-			ZB_ZCL_ARRAY_SIZE(scenes_attr_list, zb_zcl_attr_t),	   \
-			(scenes_attr_list),					   \
-			ZB_ZCL_CLUSTER_SERVER_ROLE,				   \
-			ZB_ZCL_MANUF_CODE_INVALID				   \
-		),								   \
-		ZB_ZCL_CLUSTER_DESC(						   \
-			ZB_ZCL_CLUSTER_ID_GROUPS,				   \
-			ZB_ZCL_ARRAY_SIZE(groups_attr_list, zb_zcl_attr_t),	   \
-			(groups_attr_list),					   \
-			ZB_ZCL_CLUSTER_SERVER_ROLE,				   \
-			ZB_ZCL_MANUF_CODE_INVALID				   \
-		),								   \
-		ZB_ZCL_CLUSTER_DESC(						   \
-			ZB_ZCL_CLUSTER_ID_ON_OFF,				   \
-			ZB_ZCL_ARRAY_SIZE(on_off_attr_list, zb_zcl_attr_t),	   \
-			(on_off_attr_list),					   \
-			ZB_ZCL_CLUSTER_SERVER_ROLE,				   \
-			ZB_ZCL_MANUF_CODE_INVALID				   \
-		)								   \
+		ZB_CHICKEN_COOP_IN_CLUSTERS(ZB_CHICKEN_COOP_SERVER_CLUSTER_DESC)   \
+		ZB_CHICKEN_COOP_OUT_CLUSTERS(ZB_CHICKEN_COOP_CLIENT_CLUSTER_DESC)  \
 	}
 
 
@@ -121,11 +163,8 @@
 		in_clust_num,									  \
 		out_clust_num,									  \
 		{										  \
-			ZB_ZCL_CLUSTER_ID_BASIC,						  \
-			ZB_ZCL_CLUSTER_ID_IDENTIFY,						  \
-			ZB_ZCL_CLUSTER_ID_SCENES,						  \
-			ZB_ZCL_CLUSTER_ID_GROUPS,						  \
-			ZB_ZCL_CLUSTER_ID_ON_OFF,						  \
+			ZB_CHICKEN_COOP_IN_CLUSTERS(ZB_CHICKEN_COOP_CLUSTER_ID)			  \
+			ZB_CHICKEN_COOP_OUT_CLUSTERS(ZB_CHICKEN_COOP_CLUSTER_ID)		  \
 		}										  \
 	}
 
@@ -142,8 +181,6 @@
 		ZB_CHICKEN_COOP_IN_CLUSTER_NUM, ZB_CHICKEN_COOP_OUT_CLUSTER_NUM); \
 	ZBOSS_DEVICE_DECLARE_REPORTING_CTX(reporting_info## ep_name,		      \
 		ZB_CHICKEN_COOP_REPORT_ATTR_COUNT);				      \
-	ZBOSS_DEVICE_DECLARE_LEVEL_CONTROL_CTX(cvc_alarm_info## ep_name,	      \
-		ZB_CHICKEN_COOP_CVC_ATTR_COUNT);				      \
 	ZB_AF_DECLARE_ENDPOINT_DESC(ep_name, ep_id, ZB_AF_HA_PROFILE_ID,	      \
 		0,								      \
 		NULL,								      \
@@ -151,8 +188,8 @@
 			(zb_af_simple_desc_1_1_t *)&simple_desc_## ep_name,	      \
 			ZB_CHICKEN_COOP_REPORT_ATTR_COUNT,			      \
 			reporting_info## ep_name,				      \
-			ZB_CHICKEN_COOP_CVC_ATTR_COUNT,			      \
-			cvc_alarm_info## ep_name)
+			0,							      \
+			NULL)
 
 /** @} */
 
@@ -0,0 +1,59 @@
+#include "boot_time.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+static uint32_t marks[BOOT_PHASE_COUNT];
+
+void boot_time_mark(enum boot_phase phase)
+{
+	if (!marks[phase]) {
+		/* Never 0, that means not reached. */
+		marks[phase] = MAX(k_uptime_get_32(), 1);
+	}
+}
+
+uint32_t boot_time_get(enum boot_phase phase)
+{
+	return marks[phase];
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_boot(const struct shell *sh, size_t argc, char **argv)
+{
+	static const char *const names[BOOT_PHASE_COUNT] = {
+		[BOOT_PHASE_MAIN] = "main",
+		[BOOT_PHASE_SETTINGS_INIT] = "settings init",
+		[BOOT_PHASE_SCENES_INIT] = "scenes init",
+		[BOOT_PHASE_SETTINGS_LOADED] = "settings loaded",
+		[BOOT_PHASE_ZIGBEE_ENABLED] = "zigbee enabled",
+		[BOOT_PHASE_STACK_STARTED] = "stack started",
+		[BOOT_PHASE_JOINED] = "joined",
+	};
+	uint32_t last = 0;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(sh, "%-16s %8s %8s", "phase", "at [ms]", "+ [ms]");
+
+	for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+		if (!marks[i]) {
+			shell_print(sh, "%-16s %8s", names[i], "-");
+			continue;
+		}
+
+		shell_print(sh, "%-16s %8u %8u", names[i], marks[i], marks[i] - last);
+		last = marks[i];
+	}
+
+	return 0;
+}
+
+/* Other modules add their commands with SHELL_SUBCMD_ADD((coop), ...). */
+SHELL_SUBCMD_SET_CREATE(coop_cmds, (coop));
+
+SHELL_SUBCMD_ADD((coop), boot, NULL, "Time from reset to every boot phase", cmd_boot, 1, 0);
+
+SHELL_CMD_REGISTER(coop, &coop_cmds, "Chicken coop diagnostics", NULL);
+#endif
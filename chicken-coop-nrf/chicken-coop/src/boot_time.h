@@ -0,0 +1,28 @@
+#ifndef BOOT_TIME_H
+#define BOOT_TIME_H
+
+#include <stdint.h>
+
+/* Milestones from reset to joined, in order. */
+enum boot_phase {
+	/* main() entered, the kernel and drivers are up. */
+	BOOT_PHASE_MAIN,
+	BOOT_PHASE_SETTINGS_INIT,
+	BOOT_PHASE_SCENES_INIT,
+	BOOT_PHASE_SETTINGS_LOADED,
+	/* zigbee_enable() returned, the stack thread runs. */
+	BOOT_PHASE_ZIGBEE_ENABLED,
+	/* First signal of the stack, it has read its NVRAM. */
+	BOOT_PHASE_STACK_STARTED,
+	/* Rejoined or joined a network. */
+	BOOT_PHASE_JOINED,
+	BOOT_PHASE_COUNT,
+};
+
+/**@brief Record the uptime of a phase, only the first time it is reached. */
+void boot_time_mark(enum boot_phase phase);
+
+/**@brief Uptime at which a phase was reached [ms], 0 if not yet. */
+uint32_t boot_time_get(enum boot_phase phase);
+
+#endif
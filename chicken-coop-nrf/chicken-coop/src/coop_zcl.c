@@ -0,0 +1,675 @@
+#include "coop_zcl.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "jitter.h"
+#include "light.h"
+#include "motion.h"
+#include "motion_config.h"
+#include "retained.h"
+#include "schedule.h"
+#include "sleepy.h"
+
+LOG_MODULE_REGISTER(coop_zcl, LOG_LEVEL_INF);
+
+/* Window Covering type attribute value, see section 7.4.2.1.2 of ZCL specification.
+ * The coop door only lifts, like a rollershade.
+ */
+#define COOP_WINDOW_COVERING_TYPE       0x00
+
+/* Illuminance Measurement MeasuredValue until the first sample. */
+#define ILLUMINANCE_INVALID_VALUE       0xFFFF
+
+coop_zcl_ctx_t coop_zcl_ctx;
+
+/* Latest light level, handed from the light sampling to the Zigbee thread. */
+static atomic_t light_level;
+
+/* Latest encoder position error, handed from the motion thread to the Zigbee thread. */
+static atomic_t position_error;
+
+/**@brief Function for keeping the attributes driven by the device across warm resets. */
+static void zcl_retain(void)
+{
+	struct retained_zcl zcl = {
+		.on_off = coop_zcl_ctx.on_off_attr.on_off,
+		.lift_percent = coop_zcl_ctx.window_covering_attr.current_position_lift_percentage,
+		.door_state = coop_zcl_ctx.coop_config_attr.door_state,
+		.illuminance = coop_zcl_ctx.illuminance_attr.measured_value,
+		.position_error = coop_zcl_ctx.coop_config_attr.position_error,
+	};
+
+	retained_zcl_set(&zcl);
+}
+
+/**@brief Function for handing a door command to the motion thread.
+ *
+ * A sleepy coop polls fast until the door stopped, so it stays responsive
+ * to follow-up commands such as stop.
+ *
+ * @param[in]   cmd            Command to execute.
+ * @param[in]   lift_percent   Target of MOTION_CMD_GOTO.
+ *
+ * @return 0 or -errno as for motion_submit().
+ */
+static int door_submit(enum motion_cmd cmd, zb_uint8_t lift_percent)
+{
+	int err = motion_submit(cmd, lift_percent);
+
+	if (!err && cmd != MOTION_CMD_STOP) {
+		sleepy_fast_poll_start();
+	}
+
+	return err;
+}
+
+void coop_zcl_calibrate(zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	LOG_INF("Calibrate door");
+	door_submit(MOTION_CMD_CALIBRATE, 0);
+}
+
+/**@brief Function for turning ON/OFF the light bulb.
+ *
+ * @param[in]   on   Boolean light bulb state.
+ */
+static void on_off_set_value(zb_bool_t on)
+{
+	LOG_INF("Set ON/OFF value: %i", on);
+
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_ON_OFF, ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
+			  ZB_ZCL_NON_MANUFACTURER_SPECIFIC, (zb_uint8_t *)&on);
+	zcl_retain();
+
+	/* The door is moved by the motion thread, do not block the stack here. */
+	door_submit(on ? MOTION_CMD_OPEN : MOTION_CMD_CLOSE, 0);
+}
+
+/**@brief Function for updating the lift percentage.
+ *
+ * @param[in]   lift_percent   Door position, 0 is open and 100 is closed.
+ */
+static void lift_percentage_update(zb_uint8_t lift_percent)
+{
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_WINDOW_COVERING,
+			  ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_LIFT_PERCENTAGE_ID,
+			  ZB_ZCL_NON_MANUFACTURER_SPECIFIC, &lift_percent);
+	zcl_retain();
+}
+
+/**@brief Function for updating the door state once the door stopped.
+ *
+ * The On/Off attribute follows the actual door, on while it is not fully
+ * closed, so a stopped or blocked move is reported as well.
+ *
+ * @param[in]   lift_percent   Door position, 0 is open and 100 is closed.
+ */
+static void door_stopped(zb_uint8_t lift_percent)
+{
+	zb_bool_t on = (lift_percent < 100) ? ZB_TRUE : ZB_FALSE;
+	struct jitter_stats jitter;
+
+	lift_percentage_update(lift_percent);
+	sleepy_fast_poll_stop();
+
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_ON_OFF, ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
+			  ZB_ZCL_NON_MANUFACTURER_SPECIFIC, (zb_uint8_t *)&on);
+	zcl_retain();
+
+	/* Step timing of the move that just ended, 0 without the capture. */
+	jitter_stats_get(&jitter);
+	coop_zcl_ctx.coop_config_attr.step_jitter = MIN(jitter.p99_us, UINT16_MAX);
+}
+
+/**@brief Callback from the motion thread, hands the new position to the Zigbee thread.
+ *
+ * @param[in]   lift_percent   Door position, 0 is open and 100 is closed.
+ * @param[in]   moving         False for the final position of a move.
+ */
+static void motion_position_changed(uint8_t lift_percent, bool moving)
+{
+	zb_ret_t zb_err_code = zcl_shim_schedule(
+		moving ? lift_percentage_update : door_stopped, lift_percent);
+
+	if (zb_err_code) {
+		LOG_WRN("Cannot schedule lift percentage update (err: %d)", zb_err_code);
+	}
+}
+
+/**@brief Function for running a door command decided on the device.
+ *
+ * @param[in]   cmd   MOTION_CMD_OPEN or MOTION_CMD_CLOSE.
+ */
+static void door_local_submit(zb_uint8_t cmd)
+{
+	door_submit(cmd, 0);
+}
+
+/**@brief Callback from the sun schedule and the light sensor, hands the command
+ * to the Zigbee thread.
+ *
+ * The door then moves exactly as if the coordinator had sent the command.
+ *
+ * @param[in]   cmd   MOTION_CMD_OPEN or MOTION_CMD_CLOSE.
+ */
+static void door_local_event(enum motion_cmd cmd)
+{
+	zb_ret_t zb_err_code = zcl_shim_schedule(door_local_submit, cmd);
+
+	if (zb_err_code) {
+		LOG_WRN("Cannot schedule door command (err: %d)", zb_err_code);
+	}
+}
+
+/**@brief Function for publishing the latest light level.
+ *
+ * @param  param  Unused parameter, the level does not fit into it.
+ */
+static void illuminance_update(zb_uint8_t param)
+{
+	zb_uint16_t level = atomic_get(&light_level);
+
+	ZVUNUSED(param);
+
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_ILLUMINANCE_MEASUREMENT,
+			  ZB_ZCL_ATTR_ILLUMINANCE_MEASUREMENT_MEASURED_VALUE_ID,
+			  ZB_ZCL_NON_MANUFACTURER_SPECIFIC, (zb_uint8_t *)&level);
+	zcl_retain();
+}
+
+/**@brief Callback from the light sensor, hands the level to the Zigbee thread.
+ *
+ * @param[in]   level   ZCL illuminance value.
+ */
+static void light_level_changed(uint16_t level)
+{
+	atomic_set(&light_level, level);
+
+	zb_ret_t zb_err_code = zcl_shim_schedule(illuminance_update, 0);
+
+	if (zb_err_code) {
+		LOG_WRN("Cannot schedule illuminance update (err: %d)", zb_err_code);
+	}
+}
+
+/**@brief Function for publishing the door state.
+ *
+ * @param[in]   door_state   New state, see @ref zb_zcl_coop_config_door_state_e.
+ */
+static void door_state_update(zb_uint8_t door_state)
+{
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_COOP_CONFIG, ZB_ZCL_ATTR_COOP_CONFIG_DOOR_STATE_ID,
+			  ZB_ZCL_COOP_CONFIG_MANUF_CODE, &door_state);
+	zcl_retain();
+}
+
+/**@brief Callback from the motion thread, hands the door state to the Zigbee thread.
+ *
+ * @param[in]   state   New door state.
+ */
+static void motion_state_changed(enum door_state state)
+{
+	static const zb_uint8_t door_states[] = {
+		[DOOR_STATE_CLOSED] = ZB_ZCL_COOP_CONFIG_DOOR_STATE_CLOSED,
+		[DOOR_STATE_OPENING] = ZB_ZCL_COOP_CONFIG_DOOR_STATE_OPENING,
+		[DOOR_STATE_OPEN] = ZB_ZCL_COOP_CONFIG_DOOR_STATE_OPEN,
+		[DOOR_STATE_CLOSING] = ZB_ZCL_COOP_CONFIG_DOOR_STATE_CLOSING,
+		[DOOR_STATE_STOPPED] = ZB_ZCL_COOP_CONFIG_DOOR_STATE_STOPPED,
+		[DOOR_STATE_FAULT] = ZB_ZCL_COOP_CONFIG_DOOR_STATE_FAULT,
+	};
+	zb_ret_t zb_err_code = zcl_shim_schedule(door_state_update, door_states[state]);
+
+	if (zb_err_code) {
+		LOG_WRN("Cannot schedule door state update (err: %d)", zb_err_code);
+	}
+}
+
+/**@brief Function for raising an alarm from the Zigbee thread.
+ *
+ * @param[in]   alarm_code   See @ref zb_zcl_coop_config_alarm_e.
+ */
+static void alarm_raise(zb_uint8_t alarm_code)
+{
+	zcl_shim_alarm_send(alarm_code);
+}
+
+/**@brief Callback from the motion thread, raises an alarm for a blocked door.
+ *
+ * @param[in]   closing   True if the door was blocked while closing.
+ */
+static void motion_stalled(bool closing)
+{
+	zb_ret_t zb_err_code = zcl_shim_schedule(alarm_raise,
+		closing ? ZB_ZCL_COOP_CONFIG_ALARM_OBSTRUCTED : ZB_ZCL_COOP_CONFIG_ALARM_STALLED);
+
+	if (zb_err_code) {
+		LOG_WRN("Cannot schedule alarm (err: %d)", zb_err_code);
+	}
+}
+
+/**@brief Function for publishing the position error of the last move.
+ *
+ * @param[in]   drift   Non-zero to raise a drift alarm as well.
+ */
+static void position_error_update(zb_uint8_t drift)
+{
+	zb_int16_t error = CLAMP((int32_t)atomic_get(&position_error), INT16_MIN, INT16_MAX);
+
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_COOP_CONFIG, ZB_ZCL_ATTR_COOP_CONFIG_POSITION_ERROR_ID,
+			  ZB_ZCL_COOP_CONFIG_MANUF_CODE, (zb_uint8_t *)&error);
+	zcl_retain();
+
+	if (drift) {
+		alarm_raise(ZB_ZCL_COOP_CONFIG_ALARM_DRIFT);
+	}
+}
+
+/**@brief Callback from the motion thread, hands the encoder measurement to the Zigbee thread.
+ *
+ * @param[in]   error_steps   Encoder position minus step count over the move.
+ * @param[in]   drift         Whether more steps were lost than the drift limit.
+ */
+static void motion_position_error(int32_t error_steps, bool drift)
+{
+	atomic_set(&position_error, error_steps);
+
+	zb_ret_t zb_err_code = zcl_shim_schedule(position_error_update, drift);
+
+	if (zb_err_code) {
+		LOG_WRN("Cannot schedule position error update (err: %d)", zb_err_code);
+	}
+}
+
+/**@brief Function for initializing the attributes of the door clusters. */
+static void door_attr_init(void)
+{
+	const struct retained_zcl *zcl;
+
+	/* Window Covering cluster attributes data. The position is unknown
+	 * until the door has been homed, report it as closed meanwhile.
+	 */
+	coop_zcl_ctx.window_covering_attr.window_covering_type = COOP_WINDOW_COVERING_TYPE;
+	coop_zcl_ctx.window_covering_attr.config_status =
+		ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_OPERATIONAL |
+		ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_ONLINE;
+	/* Only the encoder closes the loop, otherwise steps are just counted. */
+	if (IS_ENABLED(CONFIG_CHICKEN_COOP_ENCODER)) {
+		coop_zcl_ctx.window_covering_attr.config_status |=
+			ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_LIFT_CONTROL_IS_CLOSED_LOOP;
+	}
+	coop_zcl_ctx.window_covering_attr.current_position_lift_percentage = 100;
+	coop_zcl_ctx.window_covering_attr.installed_closed_limit_lift = 0;
+
+	/* Coop configuration cluster attributes data, the rest follows settings. */
+	coop_zcl_ctx.coop_config_attr.door_state = ZB_ZCL_COOP_CONFIG_DOOR_STATE_STOPPED;
+
+	/* Illuminance Measurement cluster attributes data, 1 lux to 10^6.5 lux. */
+	coop_zcl_ctx.illuminance_attr.measured_value = ILLUMINANCE_INVALID_VALUE;
+	coop_zcl_ctx.illuminance_attr.min_measured_value = LIGHT_LEVEL_MIN;
+	coop_zcl_ctx.illuminance_attr.max_measured_value = LIGHT_LEVEL_MAX;
+
+	/* On/Off cluster attributes data, on while the door is not fully
+	 * closed, as in door_stopped().
+	 */
+	coop_zcl_ctx.on_off_attr.on_off =
+		(coop_zcl_ctx.window_covering_attr.current_position_lift_percentage < 100) ?
+		ZB_TRUE : ZB_FALSE;
+
+	/* A warm reset continues with the values from before, the door did
+	 * not move meanwhile.
+	 */
+	zcl = retained_zcl_get();
+	if (zcl) {
+		LOG_INF("Attributes restored after warm reset");
+		coop_zcl_ctx.on_off_attr.on_off = zcl->on_off;
+		coop_zcl_ctx.window_covering_attr.current_position_lift_percentage =
+			zcl->lift_percent;
+		coop_zcl_ctx.coop_config_attr.door_state = zcl->door_state;
+		coop_zcl_ctx.coop_config_attr.position_error = zcl->position_error;
+		coop_zcl_ctx.illuminance_attr.measured_value = zcl->illuminance;
+	}
+
+	zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_ON_OFF, ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
+			  ZB_ZCL_NON_MANUFACTURER_SPECIFIC,
+			  (zb_uint8_t *)&coop_zcl_ctx.on_off_attr.on_off);
+}
+
+/**@brief Function for reporting the door state, position and light level without being polled. */
+static void door_reporting_init_all(void)
+{
+	zcl_shim_reporting_init(ZB_ZCL_CLUSTER_ID_ON_OFF, ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
+				ZB_ZCL_NON_MANUFACTURER_SPECIFIC);
+	zcl_shim_reporting_init(ZB_ZCL_CLUSTER_ID_WINDOW_COVERING,
+				ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_LIFT_PERCENTAGE_ID,
+				ZB_ZCL_NON_MANUFACTURER_SPECIFIC);
+	zcl_shim_reporting_init(ZB_ZCL_CLUSTER_ID_COOP_CONFIG, ZB_ZCL_ATTR_COOP_CONFIG_DOOR_STATE_ID,
+				ZB_ZCL_COOP_CONFIG_MANUF_CODE);
+	zcl_shim_reporting_init(ZB_ZCL_CLUSTER_ID_ILLUMINANCE_MEASUREMENT,
+				ZB_ZCL_ATTR_ILLUMINANCE_MEASUREMENT_MEASURED_VALUE_ID,
+				ZB_ZCL_NON_MANUFACTURER_SPECIFIC);
+}
+
+void coop_zcl_config_attr_init(void)
+{
+	const struct motion_config *config = motion_config_get();
+	const struct schedule_config *schedule = schedule_config_get();
+	const struct light_config *light = light_config_get();
+
+	coop_zcl_ctx.coop_config_attr.travel_steps = config->travel_steps;
+	coop_zcl_ctx.coop_config_attr.cruise_speed = config->cruise_speed;
+	coop_zcl_ctx.coop_config_attr.acceleration = config->acceleration;
+	coop_zcl_ctx.coop_config_attr.hold_timeout = config->hold_timeout;
+
+	coop_zcl_ctx.window_covering_attr.installed_open_limit_lift = config->travel_steps;
+
+	coop_zcl_ctx.coop_config_attr.schedule_enabled = schedule->enabled ? ZB_TRUE : ZB_FALSE;
+	coop_zcl_ctx.coop_config_attr.latitude = schedule->latitude;
+	coop_zcl_ctx.coop_config_attr.longitude = schedule->longitude;
+	coop_zcl_ctx.coop_config_attr.sunrise_offset = schedule->sunrise_offset;
+	coop_zcl_ctx.coop_config_attr.sunset_offset = schedule->sunset_offset;
+
+	coop_zcl_ctx.coop_config_attr.light_control = light->enabled ? ZB_TRUE : ZB_FALSE;
+	coop_zcl_ctx.coop_config_attr.dawn_level = light->dawn_level;
+	coop_zcl_ctx.coop_config_attr.dusk_level = light->dusk_level;
+}
+
+/**@brief Function for mapping a Coop configuration attribute to its motion configuration value.
+ *
+ * @param[in]   attr_id   Attribute identifier.
+ * @param[out]  key       Motion configuration value.
+ *
+ * @return ZB_TRUE if the attribute is a motion configuration value.
+ */
+static zb_bool_t coop_config_key(zb_uint16_t attr_id, enum motion_config_key *key)
+{
+	switch (attr_id) {
+	case ZB_ZCL_ATTR_COOP_CONFIG_TRAVEL_STEPS_ID:
+		*key = MOTION_CONFIG_TRAVEL_STEPS;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_CRUISE_SPEED_ID:
+		*key = MOTION_CONFIG_CRUISE_SPEED;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_ACCELERATION_ID:
+		*key = MOTION_CONFIG_ACCELERATION;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_HOLD_TIMEOUT_ID:
+		*key = MOTION_CONFIG_HOLD_TIMEOUT;
+		return ZB_TRUE;
+	default:
+		return ZB_FALSE;
+	}
+}
+
+/**@brief Function for mapping a Coop configuration attribute to its schedule configuration value.
+ *
+ * @param[in]   attr_id   Attribute identifier.
+ * @param[out]  key       Schedule configuration value.
+ *
+ * @return ZB_TRUE if the attribute is a schedule configuration value.
+ */
+static zb_bool_t coop_schedule_key(zb_uint16_t attr_id, enum schedule_config_key *key)
+{
+	switch (attr_id) {
+	case ZB_ZCL_ATTR_COOP_CONFIG_SCHEDULE_ENABLED_ID:
+		*key = SCHEDULE_CONFIG_ENABLED;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_LATITUDE_ID:
+		*key = SCHEDULE_CONFIG_LATITUDE;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_LONGITUDE_ID:
+		*key = SCHEDULE_CONFIG_LONGITUDE;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_SUNRISE_OFFSET_ID:
+		*key = SCHEDULE_CONFIG_SUNRISE_OFFSET;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_SUNSET_OFFSET_ID:
+		*key = SCHEDULE_CONFIG_SUNSET_OFFSET;
+		return ZB_TRUE;
+	default:
+		return ZB_FALSE;
+	}
+}
+
+/**@brief Function for reading a raw schedule attribute value, signed or boolean.
+ *
+ * @param[in]   attr_id   Attribute identifier.
+ * @param[in]   value     Raw little endian value.
+ */
+static zb_int32_t coop_schedule_raw_value(zb_uint16_t attr_id, zb_uint8_t *value)
+{
+	if (attr_id == ZB_ZCL_ATTR_COOP_CONFIG_SCHEDULE_ENABLED_ID) {
+		return *value;
+	}
+
+	return (zb_int16_t)sys_get_le16(value);
+}
+
+/**@brief Function for mapping a Coop configuration attribute to its light configuration value.
+ *
+ * @param[in]   attr_id   Attribute identifier.
+ * @param[out]  key       Light configuration value.
+ *
+ * @return ZB_TRUE if the attribute is a light configuration value.
+ */
+static zb_bool_t coop_light_key(zb_uint16_t attr_id, enum light_config_key *key)
+{
+	switch (attr_id) {
+	case ZB_ZCL_ATTR_COOP_CONFIG_LIGHT_CONTROL_ID:
+		*key = LIGHT_CONFIG_ENABLED;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_DAWN_LEVEL_ID:
+		*key = LIGHT_CONFIG_DAWN_LEVEL;
+		return ZB_TRUE;
+	case ZB_ZCL_ATTR_COOP_CONFIG_DUSK_LEVEL_ID:
+		*key = LIGHT_CONFIG_DUSK_LEVEL;
+		return ZB_TRUE;
+	default:
+		return ZB_FALSE;
+	}
+}
+
+/**@brief Function for reading a raw light attribute value, unsigned or boolean.
+ *
+ * @param[in]   attr_id   Attribute identifier.
+ * @param[in]   value     Raw little endian value.
+ */
+static zb_uint32_t coop_light_raw_value(zb_uint16_t attr_id, zb_uint8_t *value)
+{
+	if (attr_id == ZB_ZCL_ATTR_COOP_CONFIG_LIGHT_CONTROL_ID) {
+		return *value;
+	}
+
+	return sys_get_le16(value);
+}
+
+/**@brief Function for reading a raw attribute value, as passed by ZBOSS to the cluster hooks.
+ *
+ * @param[in]   attr_id   Attribute identifier.
+ * @param[in]   value     Raw little endian value.
+ */
+static zb_uint32_t coop_config_raw_value(zb_uint16_t attr_id, zb_uint8_t *value)
+{
+	if (attr_id == ZB_ZCL_ATTR_COOP_CONFIG_ACCELERATION_ID) {
+		return sys_get_le32(value);
+	}
+
+	return sys_get_le16(value);
+}
+
+zb_ret_t coop_zcl_config_check_value(zb_uint16_t attr_id, zb_uint8_t endpoint,
+				     zb_uint8_t *value)
+{
+	enum motion_config_key key;
+	enum schedule_config_key schedule_key;
+	enum light_config_key light_key;
+
+	ZVUNUSED(endpoint);
+
+	if (coop_config_key(attr_id, &key)) {
+		return motion_config_valid(key, coop_config_raw_value(attr_id, value)) ?
+		       RET_OK : RET_ERROR;
+	}
+
+	if (coop_schedule_key(attr_id, &schedule_key)) {
+		return schedule_config_valid(schedule_key, coop_schedule_raw_value(attr_id, value)) ?
+		       RET_OK : RET_ERROR;
+	}
+
+	if (coop_light_key(attr_id, &light_key)) {
+		return light_config_valid(light_key, coop_light_raw_value(attr_id, value)) ?
+		       RET_OK : RET_ERROR;
+	}
+
+	return RET_OK;
+}
+
+void coop_zcl_config_write(zb_uint8_t endpoint, zb_uint16_t attr_id,
+			   zb_uint8_t *new_value, zb_uint16_t manuf_code)
+{
+	enum motion_config_key key;
+	enum schedule_config_key schedule_key;
+	enum light_config_key light_key;
+	zb_uint32_t value;
+
+	ZVUNUSED(endpoint);
+	ZVUNUSED(manuf_code);
+
+	if (coop_schedule_key(attr_id, &schedule_key)) {
+		zb_int32_t schedule_value = coop_schedule_raw_value(attr_id, new_value);
+
+		LOG_INF("Schedule attribute %hd set to %d", attr_id, schedule_value);
+
+		if (schedule_config_set(schedule_key, schedule_value)) {
+			LOG_ERR("Cannot apply schedule attribute %hd", attr_id);
+		}
+		return;
+	}
+
+	if (coop_light_key(attr_id, &light_key)) {
+		value = coop_light_raw_value(attr_id, new_value);
+
+		LOG_INF("Light attribute %hd set to %u", attr_id, value);
+
+		if (light_config_set(light_key, value)) {
+			LOG_ERR("Cannot apply light attribute %hd", attr_id);
+		}
+		return;
+	}
+
+	if (!coop_config_key(attr_id, &key)) {
+		return;
+	}
+
+	value = coop_config_raw_value(attr_id, new_value);
+
+	LOG_INF("Coop configuration attribute %hd set to %u", attr_id, value);
+
+	if (motion_config_set(key, value)) {
+		LOG_ERR("Cannot apply coop configuration attribute %hd", attr_id);
+	}
+
+	if (key == MOTION_CONFIG_TRAVEL_STEPS) {
+		coop_zcl_ctx.window_covering_attr.installed_open_limit_lift = value;
+	}
+}
+
+zb_bool_t coop_zcl_device_cb(zb_zcl_device_callback_param_t *device_cb_param)
+{
+	zb_uint16_t cluster_id;
+	zb_uint16_t attr_id;
+	zb_uint8_t lift_percent;
+
+	LOG_INF("%s id %hd", __func__, device_cb_param->device_cb_id);
+
+	/* Set default response value. */
+	device_cb_param->status = RET_OK;
+
+	switch (device_cb_param->device_cb_id) {
+	case ZB_ZCL_SET_ATTR_VALUE_CB_ID:
+		cluster_id = device_cb_param->cb_param.
+			     set_attr_value_param.cluster_id;
+		attr_id = device_cb_param->cb_param.
+			  set_attr_value_param.attr_id;
+
+		if (cluster_id == ZB_ZCL_CLUSTER_ID_ON_OFF) {
+			uint8_t value =
+				device_cb_param->cb_param.set_attr_value_param
+				.values.data8;
+
+			LOG_INF("on/off attribute setting to %hd", value);
+			if (attr_id == ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID) {
+				on_off_set_value((zb_bool_t)value);
+			}
+		} else if (cluster_id == ZB_ZCL_CLUSTER_ID_COOP_CONFIG) {
+			/* Applied by coop_zcl_config_write(). */
+			LOG_DBG("Coop configuration attribute %hd set", attr_id);
+		} else if (cluster_id == ZB_ZCL_CLUSTER_ID_WINDOW_COVERING) {
+			/* Position attributes are driven by the motion thread. */
+			LOG_DBG("Window covering attribute %hd set", attr_id);
+		} else {
+			/* Other clusters can be processed here */
+			LOG_INF("Unhandled cluster attribute id: %d",
+				cluster_id);
+			device_cb_param->status = RET_NOT_IMPLEMENTED;
+		}
+		break;
+
+	case ZB_ZCL_WINDOW_COVERING_UP_OPEN_CB_ID:
+		LOG_INF("Window covering up/open");
+		door_submit(MOTION_CMD_OPEN, 0);
+		break;
+
+	case ZB_ZCL_WINDOW_COVERING_DOWN_CLOSE_CB_ID:
+		LOG_INF("Window covering down/close");
+		door_submit(MOTION_CMD_CLOSE, 0);
+		break;
+
+	case ZB_ZCL_WINDOW_COVERING_STOP_CB_ID:
+		LOG_INF("Window covering stop");
+		door_submit(MOTION_CMD_STOP, 0);
+		break;
+
+	case ZB_ZCL_WINDOW_COVERING_GO_TO_LIFT_PERCENTAGE_CB_ID:
+		lift_percent = device_cb_param->cb_param.go_to_lift_percentage
+			       .percentage_lift_value;
+
+		LOG_INF("Window covering go to lift percentage %hd", lift_percent);
+		if (door_submit(MOTION_CMD_GOTO, lift_percent)) {
+			device_cb_param->status = RET_INVALID_PARAMETER_1;
+		}
+		break;
+
+	default:
+		/* Left to the other clusters of the endpoint. */
+		return ZB_FALSE;
+	}
+
+	LOG_INF("%s status: %hd", __func__, device_cb_param->status);
+
+	return ZB_TRUE;
+}
+
+void coop_zcl_init(void)
+{
+	door_attr_init();
+
+	/* Push door state and position to bound clients instead of being polled. */
+	door_reporting_init_all();
+
+	/* Report door position and state changes from the motion thread. */
+	motion_register_position_cb(motion_position_changed);
+	motion_register_state_cb(motion_state_changed);
+	motion_register_stall_cb(motion_stalled);
+	motion_register_error_cb(motion_position_error);
+
+	/* Follow the sun and the light, also while the coordinator is unreachable. */
+	schedule_register_event_cb(door_local_event);
+	light_register_event_cb(door_local_event);
+	light_register_level_cb(light_level_changed);
+}
@@ -0,0 +1,109 @@
+#ifndef COOP_ZCL_H
+#define COOP_ZCL_H
+
+#include "zcl_shim.h"
+
+/* The door side of the coop endpoint: the On/Off, Window Covering,
+ * Illuminance Measurement and coop configuration attributes, the commands
+ * moving the door and the writes to the configuration. Built for the device
+ * and for native_sim, the stack is only reached through zcl_shim.h. Runs in
+ * the Zigbee thread unless noted otherwise.
+ */
+
+/* Window Covering cluster attributes. */
+typedef struct {
+	zb_uint8_t window_covering_type;
+	zb_uint8_t config_status;
+	zb_uint8_t current_position_lift_percentage;
+	zb_uint8_t current_position_tilt_percentage;
+	zb_uint16_t installed_open_limit_lift;
+	zb_uint16_t installed_closed_limit_lift;
+	zb_uint16_t installed_open_limit_tilt;
+	zb_uint16_t installed_closed_limit_tilt;
+	zb_uint8_t mode;
+} coop_window_covering_attrs_t;
+
+/* Illuminance Measurement cluster attributes. */
+typedef struct {
+	zb_uint16_t measured_value;
+	zb_uint16_t min_measured_value;
+	zb_uint16_t max_measured_value;
+} coop_illuminance_attrs_t;
+
+/* Coop configuration cluster attributes. */
+typedef struct {
+	zb_uint16_t travel_steps;
+	zb_uint16_t cruise_speed;
+	zb_uint32_t acceleration;
+	zb_uint16_t hold_timeout;
+	zb_uint8_t door_state;
+	zb_int16_t position_error;
+	zb_bool_t schedule_enabled;
+	zb_int16_t latitude;
+	zb_int16_t longitude;
+	zb_int16_t sunrise_offset;
+	zb_int16_t sunset_offset;
+	zb_bool_t light_control;
+	zb_uint16_t dawn_level;
+	zb_uint16_t dusk_level;
+	zb_uint32_t boot_time;
+	zb_uint16_t step_jitter;
+} coop_config_attrs_t;
+
+/* Attributes of the door clusters, the attribute lists point here. */
+typedef struct {
+	zb_zcl_on_off_attrs_t on_off_attr;
+	coop_window_covering_attrs_t window_covering_attr;
+	coop_config_attrs_t coop_config_attr;
+	coop_illuminance_attrs_t illuminance_attr;
+} coop_zcl_ctx_t;
+
+extern coop_zcl_ctx_t coop_zcl_ctx;
+
+/**@brief Set the attributes to their initial values, set up their reporting
+ * and follow the motion thread, the schedule and the light sensor.
+ *
+ * Call once the device context is registered, before settings are loaded.
+ */
+void coop_zcl_init(void);
+
+/**@brief Mirror the motion, schedule and light configuration into the attributes.
+ *
+ * Must be called after settings are loaded.
+ */
+void coop_zcl_config_attr_init(void);
+
+/**@brief Start the door calibration.
+ *
+ * @param[in]   param   Unused parameter, required by ZBOSS scheduler API.
+ */
+void coop_zcl_calibrate(zb_uint8_t param);
+
+/**@brief Handle the device callbacks of the door clusters.
+ *
+ * @param[in,out]   device_cb_param   Callback parameters, the status is set if handled.
+ *
+ * @return ZB_TRUE if the callback belongs to a door cluster.
+ */
+zb_bool_t coop_zcl_device_cb(zb_zcl_device_callback_param_t *device_cb_param);
+
+/**@brief Validate a value written to the Coop configuration cluster.
+ *
+ * @param[in]   attr_id    Attribute identifier.
+ * @param[in]   endpoint   Endpoint the attribute belongs to.
+ * @param[in]   value      Raw value to be written.
+ */
+zb_ret_t coop_zcl_config_check_value(zb_uint16_t attr_id, zb_uint8_t endpoint,
+				     zb_uint8_t *value);
+
+/**@brief Apply a value written to the Coop configuration cluster.
+ *
+ * @param[in]   endpoint     Endpoint the attribute belongs to.
+ * @param[in]   attr_id      Attribute identifier.
+ * @param[in]   new_value    Raw value written.
+ * @param[in]   manuf_code   Manufacturer code of the attribute.
+ */
+void coop_zcl_config_write(zb_uint8_t endpoint, zb_uint16_t attr_id,
+			   zb_uint8_t *new_value, zb_uint16_t manuf_code);
+
+#endif
@@ -0,0 +1,164 @@
+#include "current.h"
+#include "saadc.h"
+
+#include <errno.h>
+#include <string.h>
+#include <soc.h>
+#include <hal/nrf_saadc.h>
+#include <helpers/nrfx_gppi.h>
+#include <zephyr/kernel.h>
+
+#define current_ain NRF_SAADC_INPUT_AIN2
+#define current_channel 0
+
+/* Samples per block, the limit is checked once per block. */
+#define CURRENT_BLOCK 8
+
+/* Full scale of the SAADC with gain 1/6 and the 0.6 V internal reference [mV]. */
+#define current_full_scale_mv 3600
+
+/* Two blocks, EasyDMA fills one while the other is checked. */
+static nrf_saadc_value_t blocks[2][CURRENT_BLOCK] __aligned(4);
+static uint8_t block_idx;
+
+static uint8_t ppi_sample;
+static uint8_t ppi_restart;
+
+static current_stall_cb_t stall_cb;
+static uint32_t samples;
+static uint32_t over_blocks;
+static bool running;
+
+/* Sum of the block limit, in SAADC counts. */
+static int32_t limit_sum(void)
+{
+	uint64_t uv = (uint64_t)CONFIG_CHICKEN_COOP_CURRENT_LIMIT *
+		      CONFIG_CHICKEN_COOP_CURRENT_SHUNT * CONFIG_CHICKEN_COOP_CURRENT_GAIN;
+
+	/* mA * mOhm is uV, the full scale is in mV. Scaled to a whole block
+	 * before dividing, so the rounding does not add up over the block.
+	 */
+	return (int32_t)(uv * BIT(12) * CURRENT_BLOCK /
+			 ((uint64_t)current_full_scale_mv * 1000U));
+}
+
+/* Two samples per instruction with the dual 16 bit multiply accumulate of the M4. */
+static int32_t block_sum(const nrf_saadc_value_t *block)
+{
+	int32_t sum = 0;
+
+	for (size_t i = 0; i < CURRENT_BLOCK; i += 2) {
+		uint32_t pair;
+
+		memcpy(&pair, &block[i], sizeof(pair));
+		sum = __SMLAD(pair, 0x00010001, sum);
+	}
+
+	return sum;
+}
+
+static void block_end(void)
+{
+	const nrf_saadc_value_t *done = blocks[block_idx];
+
+	/* END already restarted the SAADC on the other block through PPI, the
+	 * block just filled is next once STARTED took the pointer.
+	 */
+	while (!nrf_saadc_event_check(NRF_SAADC, NRF_SAADC_EVENT_STARTED)) {
+	}
+	nrf_saadc_event_clear(NRF_SAADC, NRF_SAADC_EVENT_STARTED);
+	nrf_saadc_buffer_init(NRF_SAADC, blocks[block_idx], CURRENT_BLOCK);
+	block_idx ^= 1;
+
+	/* The motor draws more while it accelerates from standstill. */
+	samples += CURRENT_BLOCK;
+	if (samples <= CONFIG_CHICKEN_COOP_CURRENT_BLANK_STEPS || !stall_cb) {
+		return;
+	}
+
+	if (block_sum(done) < limit_sum()) {
+		over_blocks = 0;
+		return;
+	}
+
+	if (++over_blocks >= CONFIG_CHICKEN_COOP_STALL_BLOCKS) {
+		current_stall_cb_t cb = stall_cb;
+
+		stall_cb = NULL;
+		cb();
+	}
+}
+
+int current_sense_init(void)
+{
+	if (nrfx_gppi_channel_alloc(&ppi_sample) != NRFX_SUCCESS ||
+	    nrfx_gppi_channel_alloc(&ppi_restart) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	nrfx_gppi_channel_endpoints_setup(
+		ppi_restart, nrf_saadc_event_address_get(NRF_SAADC, NRF_SAADC_EVENT_END),
+		nrf_saadc_task_address_get(NRF_SAADC, NRF_SAADC_TASK_START));
+
+	return 0;
+}
+
+void current_sense_start(uint32_t step_event, current_stall_cb_t cb)
+{
+	nrf_saadc_channel_config_t channel_config = {
+		.resistor_p = NRF_SAADC_RESISTOR_DISABLED,
+		.resistor_n = NRF_SAADC_RESISTOR_DISABLED,
+		.gain = NRF_SAADC_GAIN1_6,
+		.reference = NRF_SAADC_REFERENCE_INTERNAL,
+		.acq_time = NRF_SAADC_ACQTIME_3US,
+		.mode = NRF_SAADC_MODE_SINGLE_ENDED,
+		.burst = NRF_SAADC_BURST_DISABLED,
+	};
+
+	/* A light sensor burst is over within a couple of milliseconds. */
+	while (!saadc_claim(block_end)) {
+		k_sleep(K_USEC(500));
+	}
+
+	samples = 0;
+	over_blocks = 0;
+	block_idx = 0;
+	stall_cb = cb;
+
+	nrf_saadc_resolution_set(NRF_SAADC, NRF_SAADC_RESOLUTION_12BIT);
+	nrf_saadc_oversample_set(NRF_SAADC, NRF_SAADC_OVERSAMPLE_DISABLED);
+	nrf_saadc_channel_init(NRF_SAADC, current_channel, &channel_config);
+	nrf_saadc_channel_input_set(NRF_SAADC, current_channel, current_ain,
+				    NRF_SAADC_INPUT_DISABLED);
+	nrf_saadc_continuous_mode_disable(NRF_SAADC);
+
+	nrf_saadc_enable(NRF_SAADC);
+	nrf_saadc_buffer_init(NRF_SAADC, blocks[0], CURRENT_BLOCK);
+	nrf_saadc_task_trigger(NRF_SAADC, NRF_SAADC_TASK_START);
+	while (!nrf_saadc_event_check(NRF_SAADC, NRF_SAADC_EVENT_STARTED)) {
+	}
+	nrf_saadc_event_clear(NRF_SAADC, NRF_SAADC_EVENT_STARTED);
+	nrf_saadc_buffer_init(NRF_SAADC, blocks[1], CURRENT_BLOCK);
+
+	nrfx_gppi_channel_endpoints_setup(
+		ppi_sample, step_event,
+		nrf_saadc_task_address_get(NRF_SAADC, NRF_SAADC_TASK_SAMPLE));
+	running = true;
+	nrfx_gppi_channels_enable(BIT(ppi_sample) | BIT(ppi_restart));
+}
+
+void current_sense_stop(void)
+{
+	unsigned int key = irq_lock();
+
+	if (!running) {
+		irq_unlock(key);
+		return;
+	}
+	running = false;
+	irq_unlock(key);
+
+	nrfx_gppi_channels_disable(BIT(ppi_sample) | BIT(ppi_restart));
+	stall_cb = NULL;
+	saadc_release();
+}
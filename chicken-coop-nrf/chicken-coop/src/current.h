@@ -0,0 +1,44 @@
+#ifndef CURRENT_H
+#define CURRENT_H
+
+/* Motor current sensing through a shunt amplifier on the SAADC. During a
+ * move every step triggers a conversion through PPI, blocks of samples are
+ * checked against the stall limit as soon as EasyDMA filled them. Without
+ * CONFIG_CHICKEN_COOP_CURRENT_SENSE these calls do nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_CURRENT_SENSE
+
+#include <stdint.h>
+
+/**@brief Callback invoked once when the current stayed above the limit, from interrupt context. */
+typedef void (*current_stall_cb_t)(void);
+
+/**@brief Allocate the PPI channels, called once by stepper_init(). */
+int current_sense_init(void);
+
+/**@brief Sample the motor current on every step until current_sense_stop().
+ *
+ * Waits for the light sensor to give up the SAADC, from thread context only.
+ *
+ * @param[in]   step_event   Address of the event marking every step.
+ * @param[in]   stall_cb     Called when the motor stalls or the door is obstructed.
+ */
+void current_sense_start(uint32_t step_event, current_stall_cb_t stall_cb);
+
+/**@brief Stop sampling and give up the SAADC. Safe from any context. */
+void current_sense_stop(void);
+
+#else
+
+#include <stdint.h>
+
+typedef void (*current_stall_cb_t)(void);
+
+static inline int current_sense_init(void) { return 0; }
+static inline void current_sense_start(uint32_t step_event, current_stall_cb_t stall_cb) {}
+static inline void current_sense_stop(void) {}
+
+#endif
+
+#endif
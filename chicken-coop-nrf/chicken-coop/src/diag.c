@@ -0,0 +1,225 @@
+#include "diag.h"
+#include "zb_zcl_coop_diagnostics.h"
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zboss_api.h>
+
+/* CPU shares are given in 0.01 %. */
+#define share_full 10000U
+
+/* Threads with attributes of their own. */
+enum diag_thread {
+	DIAG_THREAD_MAIN,
+	DIAG_THREAD_ZIGBEE,
+	DIAG_THREAD_MOTION,
+	DIAG_THREAD_WORKQ,
+	DIAG_THREAD_COUNT,
+};
+
+/* Found by name, the Zigbee thread is created by the platform code. */
+static const char *const thread_names[DIAG_THREAD_COUNT] = {
+	[DIAG_THREAD_MAIN] = "main",
+	[DIAG_THREAD_ZIGBEE] = "zboss",
+	[DIAG_THREAD_MOTION] = "motion_tid",
+	[DIAG_THREAD_WORKQ] = "sysworkq",
+};
+
+struct diag_thread_attrs {
+	zb_uint16_t cpu;
+	zb_uint16_t stack_free;
+};
+
+static zb_uint16_t cpu_load;
+static struct diag_thread_attrs threads[DIAG_THREAD_COUNT];
+static zb_uint32_t heap_peak;
+
+/* Buffer pool state, only used in the Zigbee thread. */
+static zb_uint16_t buf_low;
+static zb_uint16_t buf_oom;
+static bool buf_was_low;
+static bool buf_was_oom;
+
+ZB_ZCL_DECLARE_COOP_DIAGNOSTICS_ATTRIB_LIST(
+	diagnostics_attr_list,
+	&cpu_load,
+	&threads[DIAG_THREAD_MAIN].cpu,
+	&threads[DIAG_THREAD_MAIN].stack_free,
+	&threads[DIAG_THREAD_ZIGBEE].cpu,
+	&threads[DIAG_THREAD_ZIGBEE].stack_free,
+	&threads[DIAG_THREAD_MOTION].cpu,
+	&threads[DIAG_THREAD_MOTION].stack_free,
+	&threads[DIAG_THREAD_WORKQ].cpu,
+	&threads[DIAG_THREAD_WORKQ].stack_free,
+	&heap_peak,
+	&buf_low,
+	&buf_oom);
+
+#if CONFIG_HEAP_MEM_POOL_SIZE > 0
+/* The heap behind k_malloc(), the kernel does not declare it in a header. */
+extern struct k_heap _system_heap;
+#endif
+
+static void heap_stats_get(struct sys_memory_stats *stats)
+{
+#if CONFIG_HEAP_MEM_POOL_SIZE > 0
+	if (sys_heap_runtime_stats_get(&_system_heap.heap, stats) == 0) {
+		return;
+	}
+#endif
+	*stats = (struct sys_memory_stats){ 0 };
+}
+
+/* Cycles since boot, in the unit the kernel counts thread usage in. */
+static uint64_t uptime_cycles(void)
+{
+	return k_ticks_to_cyc_floor64(k_uptime_ticks());
+}
+
+static uint16_t thread_cpu_share(k_tid_t thread, uint64_t uptime)
+{
+	k_thread_runtime_stats_t rt;
+	uint64_t per_unit = uptime / share_full;
+
+	if (per_unit == 0 || k_thread_runtime_stats_get(thread, &rt)) {
+		return 0;
+	}
+
+	return MIN(rt.execution_cycles / per_unit, share_full);
+}
+
+static void thread_refresh(const struct k_thread *cthread, void *user_data)
+{
+	k_tid_t thread = (k_tid_t)cthread;
+	const uint64_t *uptime = user_data;
+	const char *name = k_thread_name_get(thread);
+	size_t unused;
+
+	if (name == NULL) {
+		return;
+	}
+
+	if (strcmp(name, "idle") == 0) {
+		cpu_load = share_full - thread_cpu_share(thread, *uptime);
+		return;
+	}
+
+	for (int i = 0; i < DIAG_THREAD_COUNT; i++) {
+		if (strcmp(name, thread_names[i]) != 0) {
+			continue;
+		}
+
+		threads[i].cpu = thread_cpu_share(thread, *uptime);
+		if (k_thread_stack_space_get(thread, &unused) == 0) {
+			threads[i].stack_free = MIN(unused, UINT16_MAX);
+		}
+		return;
+	}
+}
+
+/**@brief Refresh the attributes, then again after CONFIG_CHICKEN_COOP_DIAG_PERIOD.
+ *
+ * @param[in]   param   Unused parameter, required by ZBOSS scheduler API.
+ */
+static void diag_refresh(zb_uint8_t param)
+{
+	uint64_t uptime = uptime_cycles();
+	struct sys_memory_stats heap;
+
+	ZVUNUSED(param);
+
+	/* Unlocked, scanning the stacks must not hold off the step interrupts. */
+	k_thread_foreach_unlocked(thread_refresh, &uptime);
+
+	heap_stats_get(&heap);
+	heap_peak = heap.max_allocated_bytes;
+
+	diag_buf_sample();
+
+	ZB_SCHEDULE_APP_ALARM(diag_refresh, 0, ZB_TIME_ONE_SECOND * CONFIG_CHICKEN_COOP_DIAG_PERIOD);
+}
+
+void diag_network_joined(void)
+{
+	/* Restarts the refresh on a rejoin, so alarms do not stack. */
+	ZB_SCHEDULE_APP_ALARM_CANCEL(diag_refresh, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_CALLBACK(diag_refresh, 0);
+}
+
+void diag_buf_sample(void)
+{
+	bool low = zb_buf_memory_low();
+	bool oom = zb_buf_is_oom_state();
+
+	/* Count the times the pool got short, not the samples while it stays short. */
+	if (low && !buf_was_low && buf_low < UINT16_MAX) {
+		buf_low++;
+	}
+	if (oom && !buf_was_oom && buf_oom < UINT16_MAX) {
+		buf_oom++;
+	}
+
+	buf_was_low = low;
+	buf_was_oom = oom;
+}
+
+void zb_zcl_coop_diagnostics_init_server(void)
+{
+	/* Read only attributes and no commands, the stack answers the reads itself. */
+	zb_zcl_add_cluster_handlers(ZB_ZCL_CLUSTER_ID_COOP_DIAGNOSTICS,
+				    ZB_ZCL_CLUSTER_SERVER_ROLE,
+				    (zb_zcl_cluster_check_value_t)NULL,
+				    (zb_zcl_cluster_write_attr_hook_t)NULL,
+				    (zb_zcl_cluster_handler_t)NULL);
+}
+
+#ifdef CONFIG_SHELL
+struct thread_print_ctx {
+	const struct shell *sh;
+	uint64_t uptime;
+};
+
+static void thread_print(const struct k_thread *cthread, void *user_data)
+{
+	k_tid_t thread = (k_tid_t)cthread;
+	const struct thread_print_ctx *ctx = user_data;
+	const char *name = k_thread_name_get(thread);
+	uint16_t cpu = thread_cpu_share(thread, ctx->uptime);
+	size_t size = cthread->stack_info.size;
+	size_t unused;
+
+	if (k_thread_stack_space_get(thread, &unused) != 0) {
+		shell_print(ctx->sh, "%-12s cpu %3u.%02u %%", name ? name : "?",
+			    cpu / 100, cpu % 100);
+		return;
+	}
+
+	shell_print(ctx->sh, "%-12s cpu %3u.%02u %%  stack %zu/%zu used", name ? name : "?",
+		    cpu / 100, cpu % 100, size - unused, size);
+}
+
+static int cmd_diag(const struct shell *sh, size_t argc, char **argv)
+{
+	struct thread_print_ctx ctx = {
+		.sh = sh,
+		.uptime = uptime_cycles(),
+	};
+	struct sys_memory_stats heap;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	k_thread_foreach_unlocked(thread_print, &ctx);
+
+	heap_stats_get(&heap);
+	shell_print(sh, "heap: %zu used, %zu free, peak %zu", heap.allocated_bytes,
+		    heap.free_bytes, heap.max_allocated_bytes);
+	shell_print(sh, "buffer pool: low %u times, out of buffers %u times", buf_low, buf_oom);
+
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((coop), diag, NULL, "CPU, stack, heap and buffer pool usage", cmd_diag, 1, 0);
+#endif
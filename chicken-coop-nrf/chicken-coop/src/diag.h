@@ -0,0 +1,35 @@
+#ifndef DIAG_H
+#define DIAG_H
+
+/* Diagnostics cluster. The CPU share of the threads since boot, their
+ * unused stack, the heap peak and how often the ZBOSS buffer pool ran low,
+ * refreshed every CONFIG_CHICKEN_COOP_DIAG_PERIOD seconds for remote reads,
+ * which can get values that old. "coop diag" computes them when it runs.
+ * Without CONFIG_CHICKEN_COOP_DIAG these calls do nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_DIAG
+
+#include <zboss_api.h>
+
+/* Attribute list of the Diagnostics cluster, part of the coop endpoint. */
+extern zb_zcl_attr_t diagnostics_attr_list[];
+
+/**@brief Start refreshing the attributes once joined, from the Zigbee thread. */
+void diag_network_joined(void);
+
+/**@brief Check the buffer pool, from the Zigbee thread.
+ *
+ * Cheap enough to be called for every signal and frame, the pool is short
+ * of buffers when the stack is busy.
+ */
+void diag_buf_sample(void);
+
+#else
+
+static inline void diag_network_joined(void) {}
+static inline void diag_buf_sample(void) {}
+
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#include "encoder.h"
+
+#include <soc.h>
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_qdec.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+
+#define encoder_a NRF_GPIO_PIN_MAP(1, 14)
+#define encoder_b NRF_GPIO_PIN_MAP(1, 15)
+#define encoder_irq_priority 4
+
+/* The accumulator saturates at 1023 counts, one sample can add at most one. */
+#define encoder_sampleper NRF_QDEC_SAMPLEPER_128US
+#define encoder_reportper NRF_QDEC_REPORTPER_280
+
+static int32_t counts;
+
+/* Takes the report the REPORTRDY short moved to ACCREAD, if any. */
+static void report_collect(void)
+{
+	if (nrf_qdec_event_check(NRF_QDEC, NRF_QDEC_EVENT_REPORTRDY)) {
+		nrf_qdec_event_clear(NRF_QDEC, NRF_QDEC_EVENT_REPORTRDY);
+		counts += nrf_qdec_accread_get(NRF_QDEC);
+	}
+}
+
+static void encoder_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	report_collect();
+}
+
+int encoder_init(void)
+{
+	nrf_gpio_cfg_input(encoder_a, NRF_GPIO_PIN_PULLUP);
+	nrf_gpio_cfg_input(encoder_b, NRF_GPIO_PIN_PULLUP);
+
+	nrf_qdec_pins_set(NRF_QDEC, encoder_a, encoder_b, NRF_QDEC_PIN_NOT_CONNECTED);
+	nrf_qdec_sampleper_set(NRF_QDEC, encoder_sampleper);
+	nrf_qdec_reportper_set(NRF_QDEC, encoder_reportper);
+	nrf_qdec_dbfen_enable(NRF_QDEC);
+	nrf_qdec_shorts_enable(NRF_QDEC, NRF_QDEC_SHORT_REPORTRDY_READCLRACC_MASK);
+	nrf_qdec_int_enable(NRF_QDEC, NRF_QDEC_INT_REPORTRDY_MASK);
+
+	IRQ_CONNECT(QDEC_IRQn, encoder_irq_priority, encoder_isr, NULL, 0);
+	irq_enable(QDEC_IRQn);
+
+	return 0;
+}
+
+void encoder_start(void)
+{
+	counts = 0;
+
+	nrf_qdec_enable(NRF_QDEC);
+	nrf_qdec_task_trigger(NRF_QDEC, NRF_QDEC_TASK_READCLRACC);
+	nrf_qdec_event_clear(NRF_QDEC, NRF_QDEC_EVENT_REPORTRDY);
+	nrf_qdec_task_trigger(NRF_QDEC, NRF_QDEC_TASK_START);
+}
+
+int32_t encoder_stop(void)
+{
+	unsigned int key = irq_lock();
+	int32_t travelled;
+
+	/* A pending report must be taken before READCLRACC overwrites it. */
+	report_collect();
+	nrf_qdec_task_trigger(NRF_QDEC, NRF_QDEC_TASK_READCLRACC);
+	counts += nrf_qdec_accread_get(NRF_QDEC);
+
+	nrf_qdec_task_trigger(NRF_QDEC, NRF_QDEC_TASK_STOP);
+	nrf_qdec_disable(NRF_QDEC);
+
+	travelled = (int32_t)DIV_ROUND_CLOSEST((int64_t)counts * CONFIG_CHICKEN_COOP_STEPS_PER_REV,
+					       CONFIG_CHICKEN_COOP_ENCODER_COUNTS_PER_REV);
+	irq_unlock(key);
+
+	return travelled;
+}
@@ -0,0 +1,34 @@
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <stdint.h>
+
+/* Quadrature encoder on the motor shaft, counted by the QDEC peripheral.
+ * The hardware accumulates the edges, software only collects a report every
+ * 280 samples and at the end of a move. Opening must count up. Without
+ * CONFIG_CHICKEN_COOP_ENCODER these calls do nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_ENCODER
+
+/**@brief Set up the QDEC, called once by stepper_init(). */
+int encoder_init(void);
+
+/**@brief Start counting from zero, at the start of a move. */
+void encoder_start(void);
+
+/**@brief Stop counting. Safe from any context.
+ *
+ * @return Distance travelled since encoder_start() in steps, opening positive.
+ */
+int32_t encoder_stop(void);
+
+#else
+
+static inline int encoder_init(void) { return 0; }
+static inline void encoder_start(void) {}
+static inline int32_t encoder_stop(void) { return 0; }
+
+#endif
+
+#endif
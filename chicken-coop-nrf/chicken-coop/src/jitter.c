@@ -0,0 +1,206 @@
+#include "jitter.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <soc.h>
+#include <hal/nrf_egu.h>
+#include <hal/nrf_timer.h>
+#include <helpers/nrfx_gppi.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+/* TIMER2 runs free at 16 MHz while the door moves, the step edges capture
+ * it through PPI. The same PPI channel triggers EGU3, whose interrupt reads
+ * the capture before the next edge.
+ */
+#define jitter_timer NRF_TIMER2
+#define jitter_capture_cc NRF_TIMER_CC_CHANNEL0
+#define jitter_egu NRF_EGU3
+#define jitter_egu_irq SWI3_EGU3_IRQn
+/* Below the stepper, the radio and the SAADC, the edges are timed in hardware. */
+#define jitter_irq_priority 5
+
+#define jitter_ticks_per_us 16
+
+/* Absolute error by 1 us, the last bin takes everything longer. */
+#define jitter_bins 64
+
+static uint8_t ppi_ch;
+static const struct planner_move *move;
+static uint32_t edges;
+static uint32_t last_capture;
+
+/* Move in progress, only touched by the interrupt until jitter_stop(). */
+static uint16_t hist[jitter_bins];
+static uint32_t steps;
+static uint32_t missed;
+static int32_t min_ticks;
+static int32_t max_ticks;
+
+/* Last move, as published. */
+static struct jitter_stats stats;
+
+static void jitter_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (!nrf_egu_event_check(jitter_egu, NRF_EGU_EVENT_TRIGGERED0)) {
+		return;
+	}
+	nrf_egu_event_clear(jitter_egu, NRF_EGU_EVENT_TRIGGERED0);
+
+	uint32_t capture = nrf_timer_cc_get(jitter_timer, jitter_capture_cc);
+	uint32_t step = edges++;
+
+	if (step == 0) {
+		last_capture = capture;
+		return;
+	}
+
+	uint32_t span = capture - last_capture;
+	uint32_t planned = planner_interval(move, step - 1) * jitter_ticks_per_us;
+
+	last_capture = capture;
+
+	/* Edges without an interrupt, the capture was overwritten. Count the
+	 * steps the span covers by the planned intervals, so the next
+	 * interval is compared with the one planned for it.
+	 */
+	if (span > planned + planned / 2) {
+		while (step + 1 < move->steps) {
+			uint32_t next = planner_interval(move, step) * jitter_ticks_per_us;
+
+			if (span < planned + next / 2) {
+				break;
+			}
+			planned += next;
+			step++;
+			edges++;
+			missed++;
+		}
+		missed++;
+		return;
+	}
+
+	int32_t error = (int32_t)(span - planned);
+
+	if (abs(error) > (int32_t)planned / 2) {
+		missed++;
+		return;
+	}
+
+	min_ticks = MIN(min_ticks, error);
+	max_ticks = MAX(max_ticks, error);
+	hist[MIN(abs(error) / jitter_ticks_per_us, jitter_bins - 1)]++;
+	steps++;
+}
+
+int jitter_init(void)
+{
+	if (nrfx_gppi_channel_alloc(&ppi_ch) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	nrf_timer_mode_set(jitter_timer, NRF_TIMER_MODE_TIMER);
+	nrf_timer_bit_width_set(jitter_timer, NRF_TIMER_BIT_WIDTH_32);
+	nrf_timer_prescaler_set(jitter_timer, NRF_TIMER_FREQ_16MHz);
+
+	nrf_egu_int_enable(jitter_egu, NRF_EGU_INT_TRIGGERED0);
+
+	IRQ_CONNECT(jitter_egu_irq, jitter_irq_priority, jitter_isr, NULL, 0);
+	irq_enable(jitter_egu_irq);
+
+	return 0;
+}
+
+void jitter_start(uint32_t step_event, const struct planner_move *planned)
+{
+	move = planned;
+	edges = 0;
+	steps = 0;
+	missed = 0;
+	min_ticks = INT32_MAX;
+	max_ticks = INT32_MIN;
+	memset(hist, 0, sizeof(hist));
+
+	nrf_egu_event_clear(jitter_egu, NRF_EGU_EVENT_TRIGGERED0);
+	nrfx_gppi_channel_endpoints_setup(ppi_ch, step_event,
+		nrf_timer_task_address_get(jitter_timer,
+					   nrf_timer_capture_task_get(jitter_capture_cc)));
+	nrfx_gppi_fork_endpoint_setup(ppi_ch,
+		nrf_egu_task_address_get(jitter_egu, NRF_EGU_TASK_TRIGGER0));
+
+	nrf_timer_task_trigger(jitter_timer, NRF_TIMER_TASK_CLEAR);
+	nrf_timer_task_trigger(jitter_timer, NRF_TIMER_TASK_START);
+	nrfx_gppi_channels_enable(BIT(ppi_ch));
+}
+
+void jitter_stop(void)
+{
+	unsigned int key = irq_lock();
+
+	nrfx_gppi_channels_disable(BIT(ppi_ch));
+	nrf_timer_task_trigger(jitter_timer, NRF_TIMER_TASK_STOP);
+
+	/* The last edge may still wait for its interrupt. */
+	jitter_isr(NULL);
+
+	uint32_t rank = steps - steps / 100;
+	uint32_t count = 0;
+	uint32_t bin = 0;
+
+	while (bin < jitter_bins - 1 && count + hist[bin] < rank) {
+		count += hist[bin++];
+	}
+
+	stats = (struct jitter_stats){
+		.steps = steps,
+		.missed = missed,
+		.min_ns = steps ? (int64_t)min_ticks * 1000 / jitter_ticks_per_us : 0,
+		.max_ns = steps ? (int64_t)max_ticks * 1000 / jitter_ticks_per_us : 0,
+		.p99_us = steps ? bin + 1 : 0,
+	};
+	irq_unlock(key);
+}
+
+void jitter_stats_get(struct jitter_stats *out)
+{
+	unsigned int key = irq_lock();
+
+	*out = stats;
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_jitter(const struct shell *sh, size_t argc, char **argv)
+{
+	struct jitter_stats now;
+	uint16_t bins[jitter_bins];
+	unsigned int key = irq_lock();
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	now = stats;
+	memcpy(bins, hist, sizeof(bins));
+	irq_unlock(key);
+
+	shell_print(sh, "last move: %u intervals, %u missed, error %d..%d ns, p99 %u us",
+		    now.steps, now.missed, now.min_ns, now.max_ns, now.p99_us);
+
+	for (int i = 0; i < jitter_bins; i++) {
+		if (bins[i]) {
+			bool last_bin = i == jitter_bins - 1;
+
+			shell_print(sh, "%s%2d us %5u", last_bin ? ">=" : "< ",
+				    last_bin ? i : i + 1, bins[i]);
+		}
+	}
+
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((coop), jitter, NULL, "Step timing error of the last move", cmd_jitter, 1, 0);
+#endif
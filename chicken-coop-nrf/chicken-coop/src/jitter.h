@@ -0,0 +1,56 @@
+#ifndef JITTER_H
+#define JITTER_H
+
+#include <stdint.h>
+
+#include "planner.h"
+
+/* Step timing capture. A free running TIMER captures every step edge
+ * through PPI, the time between two edges is compared with the planned
+ * interval and the error binned into a histogram, per move. Without
+ * CONFIG_CHICKEN_COOP_JITTER these calls do nothing.
+ */
+
+/* Step timing of the last move. */
+struct jitter_stats {
+	/* Intervals measured. */
+	uint32_t steps;
+	/* Intervals not measured, the capture was overwritten before it was read. */
+	uint32_t missed;
+	/* Smallest and largest error against the planned interval [ns]. */
+	int32_t min_ns;
+	int32_t max_ns;
+	/* 99th percentile of the absolute error [us], rounded up. */
+	uint32_t p99_us;
+};
+
+#ifdef CONFIG_CHICKEN_COOP_JITTER
+
+/**@brief Set up the TIMER and the PPI channel, called once by stepper_init(). */
+int jitter_init(void);
+
+/**@brief Capture the steps of a move, at its start.
+ *
+ * @param[in]   step_event   Address of the event fired at every step edge.
+ * @param[in]   move         Planned move, followed when it gets shortened.
+ */
+void jitter_start(uint32_t step_event, const struct planner_move *move);
+
+/**@brief Stop capturing at the end of a move. Safe from any context. */
+void jitter_stop(void);
+
+void jitter_stats_get(struct jitter_stats *stats);
+
+#else
+
+static inline int jitter_init(void) { return 0; }
+static inline void jitter_start(uint32_t step_event, const struct planner_move *move) {}
+static inline void jitter_stop(void) {}
+static inline void jitter_stats_get(struct jitter_stats *stats)
+{
+	*stats = (struct jitter_stats){ 0 };
+}
+
+#endif
+
+#endif
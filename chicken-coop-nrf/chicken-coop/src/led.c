@@ -0,0 +1,172 @@
+#include "led.h"
+
+#include <soc.h>
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_pwm.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+
+/* PWM0 belongs to the Zephyr PWM driver and PWM1 to the stepper, the LEDs use PWM2. */
+#define led_pwm NRF_PWM2
+#define led_pwm_irq PWM2_IRQn
+#define led_pwm_irq_priority 5
+
+/* 125 kHz / 1250 gives a 10 ms PWM period, and every sequence entry is
+ * played for 10 periods: the animation advances every 100 ms.
+ */
+#define led_pwm_top 1250
+#define led_pwm_refresh 9
+
+/* Length of one animation cycle, 2 s. */
+#define led_seq_len 20
+
+#define LED_DT(alias)									\
+	{										\
+		.pin = NRF_DT_GPIOS_TO_PSEL(DT_ALIAS(alias), gpios),			\
+		.active_low = DT_GPIO_FLAGS(DT_ALIAS(alias), gpios) & GPIO_ACTIVE_LOW,	\
+	}
+
+/* Same LEDs as DK_LED1, DK_LED3 and DK_LED4 of the DK library. */
+static const struct {
+	uint32_t pin;
+	bool active_low;
+} leds[LED_COUNT] = {
+	[LED_RUN] = LED_DT(led0),
+	[LED_NETWORK] = LED_DT(led2),
+	[LED_IDENTIFY] = LED_DT(led3),
+};
+
+/* Played in a loop by EasyDMA, one duty cycle per LED and entry. Sequence 0
+ * and 1 both point here, and the end of the loop restarts sequence 0.
+ */
+static nrf_pwm_values_individual_t seq[led_seq_len];
+
+static enum led_pattern patterns[LED_COUNT];
+static bool running;
+
+static bool pattern_lit(enum led_pattern pattern, uint32_t entry)
+{
+	switch (pattern) {
+	case LED_PATTERN_ON:
+		return true;
+	case LED_PATTERN_HEARTBEAT:
+		return entry < led_seq_len / 2;
+	case LED_PATTERN_BLINK:
+		return entry % 2;
+	default:
+		return false;
+	}
+}
+
+static bool pattern_blinks(enum led_pattern pattern)
+{
+	return pattern == LED_PATTERN_HEARTBEAT || pattern == LED_PATTERN_BLINK;
+}
+
+static bool led_level(enum led_id led, bool lit)
+{
+	return lit != leds[led].active_low;
+}
+
+/* The pin is high for the first value ticks of every period, so the extremes
+ * hold it at one level for the whole period.
+ */
+static uint16_t level_value(bool high)
+{
+	return high ? led_pwm_top : 0;
+}
+
+static void seq_update(void)
+{
+	for (uint32_t i = 0; i < led_seq_len; i++) {
+		uint16_t *values = (uint16_t *)&seq[i];
+
+		for (int led = 0; led < LED_COUNT; led++) {
+			values[led] = level_value(led_level(led, pattern_lit(patterns[led], i)));
+		}
+	}
+}
+
+static void led_pwm_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (!nrf_pwm_event_check(led_pwm, NRF_PWM_EVENT_STOPPED)) {
+		return;
+	}
+	nrf_pwm_event_clear(led_pwm, NRF_PWM_EVENT_STOPPED);
+
+	/* Hand the pins back to GPIO, unless an animation was started meanwhile. */
+	if (running) {
+		nrf_pwm_task_trigger(led_pwm, NRF_PWM_TASK_SEQSTART0);
+	} else {
+		nrf_pwm_disable(led_pwm);
+	}
+}
+
+int led_init(void)
+{
+	uint32_t pins[NRF_PWM_CHANNEL_COUNT] = {
+		leds[LED_RUN].pin,
+		leds[LED_NETWORK].pin,
+		leds[LED_IDENTIFY].pin,
+		NRF_PWM_PIN_NOT_CONNECTED,
+	};
+
+	for (int led = 0; led < LED_COUNT; led++) {
+		nrf_gpio_pin_write(leds[led].pin, led_level(led, false));
+		nrf_gpio_cfg_output(leds[led].pin);
+	}
+
+	seq_update();
+
+	nrf_pwm_pins_set(led_pwm, pins);
+	nrf_pwm_configure(led_pwm, NRF_PWM_CLK_125kHz, NRF_PWM_MODE_UP, led_pwm_top);
+	nrf_pwm_decoder_set(led_pwm, NRF_PWM_LOAD_INDIVIDUAL, NRF_PWM_STEP_AUTO);
+
+	for (uint8_t i = 0; i < 2; i++) {
+		nrf_pwm_seq_ptr_set(led_pwm, i, (uint16_t *)seq);
+		nrf_pwm_seq_cnt_set(led_pwm, i, led_seq_len * NRF_PWM_CHANNEL_COUNT);
+		nrf_pwm_seq_refresh_set(led_pwm, i, led_pwm_refresh);
+		nrf_pwm_seq_end_delay_set(led_pwm, i, 0);
+	}
+
+	/* Loop forever without any CPU involvement. */
+	nrf_pwm_loop_set(led_pwm, 1);
+	nrf_pwm_shorts_set(led_pwm, NRF_PWM_SHORT_LOOPSDONE_SEQSTART0_MASK);
+	nrf_pwm_int_set(led_pwm, NRF_PWM_INT_STOPPED_MASK);
+
+	IRQ_CONNECT(led_pwm_irq, led_pwm_irq_priority, led_pwm_isr, NULL, 0);
+	irq_enable(led_pwm_irq);
+
+	return 0;
+}
+
+void led_pattern_set(enum led_id led, enum led_pattern pattern)
+{
+	bool blinking = false;
+	unsigned int key = irq_lock();
+
+	patterns[led] = pattern;
+	seq_update();
+
+	/* Levels of the steady LEDs, only visible while the PWM is disabled. */
+	for (int i = 0; i < LED_COUNT; i++) {
+		nrf_gpio_pin_write(leds[i].pin, led_level(i, pattern_lit(patterns[i], 0)));
+		blinking |= pattern_blinks(patterns[i]);
+	}
+
+	if (blinking && !running) {
+		running = true;
+		nrf_pwm_enable(led_pwm);
+		nrf_pwm_task_trigger(led_pwm, NRF_PWM_TASK_SEQSTART0);
+	} else if (!blinking && running) {
+		/* Disabled by the interrupt at the end of the current period. */
+		running = false;
+		nrf_pwm_task_trigger(led_pwm, NRF_PWM_TASK_STOP);
+	}
+
+	irq_unlock(key);
+}
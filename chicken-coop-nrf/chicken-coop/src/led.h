@@ -0,0 +1,39 @@
+#ifndef LED_H
+#define LED_H
+
+/* Status LEDs, animated in hardware. */
+enum led_id {
+	/* Heartbeat showing the firmware runs. */
+	LED_RUN,
+	/* On while joined to a Zigbee network. */
+	LED_NETWORK,
+	/* Blinks while the endpoint identifies itself. */
+	LED_IDENTIFY,
+	LED_COUNT,
+};
+
+enum led_pattern {
+	LED_PATTERN_OFF,
+	LED_PATTERN_ON,
+	/* 1 s on, 1 s off. */
+	LED_PATTERN_HEARTBEAT,
+	/* Toggles every 100 ms. */
+	LED_PATTERN_BLINK,
+};
+
+/**@brief Set up the LED pins and the PWM instance playing the animations. */
+int led_init(void);
+
+/**@brief Change the pattern of an LED.
+ *
+ * Blinking patterns are played by PWM with EasyDMA out of a sequence in RAM,
+ * without any interrupt or thread wakeup. The PWM only runs while at least
+ * one LED blinks, steady LEDs are plain GPIO outputs. Safe to call from any
+ * context.
+ *
+ * @param[in]   led       LED to change.
+ * @param[in]   pattern   New pattern.
+ */
+void led_pattern_set(enum led_id led, enum led_pattern pattern);
+
+#endif
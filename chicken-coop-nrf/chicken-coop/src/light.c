@@ -0,0 +1,251 @@
+#include "light.h"
+
+#include <stdlib.h>
+#include <soc.h>
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_saadc.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include "saadc.h"
+
+LOG_MODULE_REGISTER(light, LOG_LEVEL_INF);
+
+/* Fixed resistor from light_supply to light_ain, photoresistor from
+ * light_ain to ground. The supply is only on during a burst.
+ */
+#define light_ain NRF_SAADC_INPUT_AIN1
+#define light_supply NRF_GPIO_PIN_MAP(1, 13)
+#define light_channel 0
+
+/* 16 MHz / 2047 is about 7.8 kHz, a burst takes 2 ms. */
+#define light_sample_cc 2047
+#define LIGHT_BATCH 16
+
+/* Sum of a full scale burst. The reference is VDD, the reading does not
+ * depend on the supply voltage.
+ */
+#define LIGHT_FULL_SCALE (LIGHT_BATCH * 4096)
+
+/* 100 * 10000 * log10(2), turns a log2 difference into an illuminance value. */
+#define LOG10_2_LEVEL 301030LL
+
+/* Level reported when too dark to measure. */
+#define LIGHT_LEVEL_TOO_DARK 0
+
+/* Changes smaller than about 2% of the lux value are not passed on. */
+#define LIGHT_PUBLISH_CHANGE 100
+
+enum light_phase {
+	LIGHT_PHASE_UNKNOWN,
+	LIGHT_PHASE_DAY,
+	LIGHT_PHASE_NIGHT,
+};
+
+static light_level_cb_t level_cb;
+static light_event_cb_t event_cb;
+
+/* Written by EasyDMA, read by the workqueue long before the next burst. */
+static nrf_saadc_value_t samples[LIGHT_BATCH];
+
+/* Only touched by the sample work. */
+static int32_t filtered;
+static bool filter_primed;
+static uint16_t published;
+static enum light_phase phase;
+static uint32_t hold;
+
+/* Integer log2 in Q16, one squaring per fraction bit. */
+static int32_t log2_q16(uint32_t x)
+{
+	int32_t msb = 31 - __builtin_clz(x);
+	/* Mantissa in [1, 2), Q30. */
+	uint32_t m = (msb >= 30) ? x >> (msb - 30) : x << (30 - msb);
+	int32_t result = msb << 16;
+
+	for (int32_t bit = 1 << 15; bit; bit >>= 1) {
+		m = ((uint64_t)m * m) >> 30;
+		if (m >= (2U << 30)) {
+			m >>= 1;
+			result += bit;
+		}
+	}
+
+	return result;
+}
+
+/* The photoresistor follows R = R10 * (lux / 10)^-gamma, so
+ * log10(lux) = 1 + (log10(R10) - log10(R)) / gamma.
+ */
+static uint16_t level_from_sum(uint32_t sum)
+{
+	if (sum >= LIGHT_FULL_SCALE) {
+		return LIGHT_LEVEL_TOO_DARK;
+	}
+	if (sum == 0) {
+		return LIGHT_LEVEL_MAX;
+	}
+
+	/* R = Rfixed * sum / (full scale - sum) */
+	int64_t diff = (int64_t)log2_q16(CONFIG_CHICKEN_COOP_LIGHT_R10) -
+		       log2_q16(CONFIG_CHICKEN_COOP_LIGHT_FIXED_RESISTOR) -
+		       log2_q16(sum) + log2_q16(LIGHT_FULL_SCALE - sum);
+	int64_t level = 10001 + diff * LOG10_2_LEVEL /
+			((int64_t)CONFIG_CHICKEN_COOP_LIGHT_GAMMA << 16);
+
+	if (level < LIGHT_LEVEL_MIN) {
+		return LIGHT_LEVEL_TOO_DARK;
+	}
+
+	return MIN(level, LIGHT_LEVEL_MAX);
+}
+
+/* The door only moves once the level stayed past a threshold for
+ * CONFIG_CHICKEN_COOP_LIGHT_HOLD samples in a row, clouds and headlights
+ * do not count. The first samples after boot only learn the phase.
+ */
+static void phase_update(uint16_t level)
+{
+	const struct light_config *config = light_config_get();
+	enum light_phase target;
+
+	if (level >= config->dawn_level) {
+		target = LIGHT_PHASE_DAY;
+	} else if (level <= config->dusk_level) {
+		target = LIGHT_PHASE_NIGHT;
+	} else {
+		hold = 0;
+		return;
+	}
+
+	if (phase == LIGHT_PHASE_UNKNOWN) {
+		phase = target;
+		return;
+	}
+
+	if (target == phase) {
+		hold = 0;
+		return;
+	}
+
+	if (++hold < CONFIG_CHICKEN_COOP_LIGHT_HOLD) {
+		return;
+	}
+
+	hold = 0;
+	phase = target;
+
+	LOG_INF("%s at level %u", phase == LIGHT_PHASE_DAY ? "Dawn" : "Dusk", level);
+	if (config->enabled && event_cb) {
+		event_cb(phase == LIGHT_PHASE_DAY ? MOTION_CMD_OPEN : MOTION_CMD_CLOSE);
+	}
+}
+
+static void sample_work_handler(struct k_work *work)
+{
+	uint32_t sum = 0;
+
+	ARG_UNUSED(work);
+
+	for (int i = 0; i < LIGHT_BATCH; i++) {
+		sum += MAX(samples[i], 0);
+	}
+
+	/* First order low pass in Q8, 2^CONFIG_CHICKEN_COOP_LIGHT_FILTER samples
+	 * time constant.
+	 */
+	int32_t level = level_from_sum(sum) << 8;
+
+	if (!filter_primed) {
+		filtered = level;
+		filter_primed = true;
+	} else {
+		filtered += (level - filtered) >> CONFIG_CHICKEN_COOP_LIGHT_FILTER;
+	}
+
+	uint16_t current = filtered >> 8;
+
+	phase_update(current);
+
+	if (abs(current - published) >= LIGHT_PUBLISH_CHANGE ||
+	    (current == LIGHT_LEVEL_TOO_DARK) != (published == LIGHT_LEVEL_TOO_DARK)) {
+		published = current;
+		if (level_cb) {
+			level_cb(current);
+		}
+	}
+}
+
+static K_WORK_DEFINE(sample_work, sample_work_handler);
+
+static void burst_end(void)
+{
+	saadc_release();
+	nrf_gpio_pin_clear(light_supply);
+
+	k_work_submit(&sample_work);
+}
+
+/* Starts a burst, EasyDMA takes it from here. */
+static void sample_timer_expiry(struct k_timer *timer)
+{
+	nrf_saadc_channel_config_t channel_config = {
+		.resistor_p = NRF_SAADC_RESISTOR_DISABLED,
+		.resistor_n = NRF_SAADC_RESISTOR_DISABLED,
+		.gain = NRF_SAADC_GAIN1_4,
+		.reference = NRF_SAADC_REFERENCE_VDD4,
+		.acq_time = NRF_SAADC_ACQTIME_40US,
+		.mode = NRF_SAADC_MODE_SINGLE_ENDED,
+		.burst = NRF_SAADC_BURST_DISABLED,
+	};
+
+	ARG_UNUSED(timer);
+
+	/* The motor current is sampled while the door moves, skip this one. */
+	if (!saadc_claim(burst_end)) {
+		return;
+	}
+
+	nrf_saadc_resolution_set(NRF_SAADC, NRF_SAADC_RESOLUTION_12BIT);
+	nrf_saadc_oversample_set(NRF_SAADC, NRF_SAADC_OVERSAMPLE_DISABLED);
+	nrf_saadc_channel_init(NRF_SAADC, light_channel, &channel_config);
+	nrf_saadc_channel_input_set(NRF_SAADC, light_channel, light_ain,
+				    NRF_SAADC_INPUT_DISABLED);
+	nrf_saadc_continuous_mode_enable(NRF_SAADC, light_sample_cc);
+
+	nrf_gpio_pin_set(light_supply);
+	nrf_saadc_enable(NRF_SAADC);
+	nrf_saadc_buffer_init(NRF_SAADC, samples, LIGHT_BATCH);
+	nrf_saadc_task_trigger(NRF_SAADC, NRF_SAADC_TASK_START);
+
+	/* STARTED only takes the buffer pointer, it follows within a few cycles. */
+	while (!nrf_saadc_event_check(NRF_SAADC, NRF_SAADC_EVENT_STARTED)) {
+	}
+	nrf_saadc_event_clear(NRF_SAADC, NRF_SAADC_EVENT_STARTED);
+
+	/* Starts the SAADC sample timer, it samples until the buffer is full. */
+	nrf_saadc_task_trigger(NRF_SAADC, NRF_SAADC_TASK_SAMPLE);
+}
+
+static K_TIMER_DEFINE(sample_timer, sample_timer_expiry, NULL);
+
+int light_init(void)
+{
+	nrf_gpio_pin_clear(light_supply);
+	nrf_gpio_cfg_output(light_supply);
+
+	k_timer_start(&sample_timer, K_NO_WAIT, K_SECONDS(CONFIG_CHICKEN_COOP_LIGHT_INTERVAL));
+
+	return 0;
+}
+
+void light_register_level_cb(light_level_cb_t cb)
+{
+	level_cb = cb;
+}
+
+void light_register_event_cb(light_event_cb_t cb)
+{
+	event_cb = cb;
+}
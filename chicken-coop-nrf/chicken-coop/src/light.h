@@ -0,0 +1,94 @@
+#ifndef LIGHT_H
+#define LIGHT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "motion.h"
+
+/* Ambient light from a photoresistor on the SAADC. Levels are ZCL
+ * illuminance values, 10000 * log10(lux) + 1, and 0 when too dark to measure.
+ * The configuration lives in light_config.c, also built without the sensor.
+ */
+
+/* Measurable levels of the Illuminance Measurement cluster. */
+#define LIGHT_LEVEL_MIN 1
+#define LIGHT_LEVEL_MAX 0xFFFE
+
+/* Light parameters that can be tuned at runtime. */
+enum light_config_key {
+	/* Whether the door follows dusk and dawn. */
+	LIGHT_CONFIG_ENABLED,
+	/* Level at or above which the door opens. */
+	LIGHT_CONFIG_DAWN_LEVEL,
+	/* Level at or below which the door closes, lower than the dawn level. */
+	LIGHT_CONFIG_DUSK_LEVEL,
+	LIGHT_CONFIG_COUNT,
+};
+
+struct light_config {
+	bool enabled;
+	uint16_t dawn_level;
+	uint16_t dusk_level;
+};
+
+/**@brief Callback reporting a new filtered light level.
+ *
+ * Called from the system workqueue, only once the level changed noticeably.
+ *
+ * @param[in]   level   ZCL illuminance value.
+ */
+typedef void (*light_level_cb_t)(uint16_t level);
+
+/**@brief Callback running a door command at dusk or dawn.
+ *
+ * Called from the system workqueue.
+ *
+ * @param[in]   cmd   MOTION_CMD_OPEN or MOTION_CMD_CLOSE.
+ */
+typedef void (*light_event_cb_t)(enum motion_cmd cmd);
+
+/* The native_sim build has no light sensor, only its configuration. */
+#ifndef CONFIG_CHICKEN_COOP_SIM
+
+/**@brief Set up the SAADC and start sampling every CONFIG_CHICKEN_COOP_LIGHT_INTERVAL.
+ *
+ * Every sample is a burst taken by EasyDMA at the SAADC sample rate, with a
+ * single interrupt at its end. The SAADC and the photoresistor divider are
+ * only powered during the burst.
+ */
+int light_init(void);
+
+void light_register_level_cb(light_level_cb_t cb);
+
+void light_register_event_cb(light_event_cb_t cb);
+
+#else
+
+static inline int light_init(void) { return 0; }
+static inline void light_register_level_cb(light_level_cb_t cb) {}
+static inline void light_register_event_cb(light_event_cb_t cb) {}
+
+#endif
+
+/**@brief Get the configuration.
+ *
+ * Loaded from settings by settings_load(), starting from the Kconfig defaults.
+ */
+const struct light_config *light_config_get(void);
+
+/**@brief Change a value and persist it.
+ *
+ * @param[in]   key     Value to change.
+ * @param[in]   value   New value.
+ *
+ * @retval 0        Value changed.
+ * @retval -EINVAL  Value out of range, or the dusk level would not be below
+ *                  the dawn level.
+ */
+int light_config_set(enum light_config_key key, uint32_t value);
+
+/**@brief Check whether a value is valid without changing anything. */
+bool light_config_valid(enum light_config_key key, uint32_t value);
+
+#endif
@@ -0,0 +1,90 @@
+#include "light.h"
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "params.h"
+
+LOG_MODULE_REGISTER(light_config, LOG_LEVEL_INF);
+
+#define LIGHT_SUBTREE "light"
+
+static struct light_config config = {
+	.enabled = IS_ENABLED(CONFIG_CHICKEN_COOP_LIGHT_CONTROL),
+	.dawn_level = CONFIG_CHICKEN_COOP_DAWN_LEVEL,
+	.dusk_level = CONFIG_CHICKEN_COOP_DUSK_LEVEL,
+};
+
+/* Settings key, storage and valid range of every value. */
+static const struct param_entry entries[LIGHT_CONFIG_COUNT] = {
+	[LIGHT_CONFIG_ENABLED] = {
+		"enabled", &config.enabled, PARAM_BOOL, 0, 1
+	},
+	[LIGHT_CONFIG_DAWN_LEVEL] = {
+		"dawn", &config.dawn_level, PARAM_U16, LIGHT_LEVEL_MIN, LIGHT_LEVEL_MAX
+	},
+	[LIGHT_CONFIG_DUSK_LEVEL] = {
+		"dusk", &config.dusk_level, PARAM_U16, LIGHT_LEVEL_MIN, LIGHT_LEVEL_MAX
+	},
+};
+
+PARAM_TABLE_DEFINE(params, LIGHT_SUBTREE, entries);
+
+const struct light_config *light_config_get(void)
+{
+	return &config;
+}
+
+bool light_config_valid(enum light_config_key key, uint32_t value)
+{
+	if (!param_in_range(&params, key, value)) {
+		return false;
+	}
+
+	switch (key) {
+	case LIGHT_CONFIG_DAWN_LEVEL:
+		return value > config.dusk_level;
+	case LIGHT_CONFIG_DUSK_LEVEL:
+		return value < config.dawn_level;
+	default:
+		return true;
+	}
+}
+
+int light_config_set(enum light_config_key key, uint32_t value)
+{
+	if (!light_config_valid(key, value)) {
+		return -EINVAL;
+	}
+
+	param_set(&params, key, value);
+
+	return 0;
+}
+
+static int light_settings_set(const char *name, size_t len,
+			      settings_read_cb read_cb, void *cb_arg)
+{
+	int key;
+	int32_t value;
+	int rc = param_read(&params, name, len, read_cb, cb_arg, &key, &value);
+
+	if (rc) {
+		return rc;
+	}
+
+	/* Only the range, the other level may not be loaded yet. */
+	if (!param_in_range(&params, key, value)) {
+		LOG_WRN("Ignoring stored %s: %d", entries[key].name, value);
+		return 0;
+	}
+
+	param_value_set(&params, key, value);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(light, LIGHT_SUBTREE, NULL,
+			       light_settings_set, NULL, NULL);
@@ -17,22 +17,26 @@
 #include <zephyr/logging/log.h>
 #include <dk_buttons_and_leds.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
 
 #include <zboss_api.h>
 #include <zboss_api_addons.h>
-#include <zb_mem_config_med.h>
 #include <zigbee/zigbee_app_utils.h>
 #include <zigbee/zigbee_error_handler.h>
 #include <zigbee/zigbee_zcl_scenes.h>
 #include <zb_nrf_platform.h>
 #include "zigbee.h"
-#include "stepper.h"
-
-#define RUN_STATUS_LED                  DK_LED1
-#define RUN_LED_BLINK_INTERVAL          1000
-
-/* Device endpoint, used to receive light controlling commands. */
-#define CHICKEN_COOP_ENDPOINT         10
+#include "zb_mem_config_coop.h"
+#include "boot_time.h"
+#include "coop_zcl.h"
+#include "diag.h"
+#include "led.h"
+#include "light.h"
+#include "motion.h"
+#include "rejoin.h"
+#include "schedule.h"
+#include "sleepy.h"
 
 /* Version of the application software (1 byte). */
 #define BULB_INIT_BASIC_APP_VERSION     01
@@ -57,7 +61,11 @@
 /* Type of power sources available for the device.
  * For possible values see section 3.2.2.2.8 of ZCL specification.
  */
+#ifdef CONFIG_CHICKEN_COOP_SLEEPY
+#define BULB_INIT_BASIC_POWER_SOURCE    ZB_ZCL_BASIC_POWER_SOURCE_BATTERY
+#else
 #define BULB_INIT_BASIC_POWER_SOURCE    ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE
+#endif
 
 /* Describes the physical location of the device (16 bytes).
  * May be modified during commissioning process.
@@ -69,18 +77,26 @@
  */
 #define BULB_INIT_BASIC_PH_ENV          ZB_ZCL_BASIC_ENV_UNSPECIFIED
 
-/* LED indicating that light switch successfully joind Zigbee network. */
-#define ZIGBEE_NETWORK_STATE_LED        DK_LED3
+/* Short address of the coordinator, hosting the Time cluster server. */
+#define TIME_SERVER_ADDR                0x0000
 
-/* LED immitaing dimmable light bulb - define for informational
- * purposes only.
- */
-#define IDENTIFY_LED                        DK_LED4
+/* Interval between time reads until the coordinator answered once [s]. */
+#define TIME_SYNC_RETRY_INTERVAL        60
+
+/* The ZCL Time attribute counts seconds since 2000-01-01 00:00 UTC. */
+#define ZCL_TIME_EPOCH_UNIX             946684800LL
 
 /* Button used to enter the Bulb into the Identify mode. */
 #define IDENTIFY_MODE_BUTTON            DK_BTN4_MSK
 
-#ifndef ZB_ROUTER_ROLE
+/* Button starting the door calibration. */
+#define CALIBRATE_BUTTON                DK_BTN3_MSK
+
+#if defined(CONFIG_CHICKEN_COOP_SLEEPY)
+#ifndef ZB_ED_ROLE
+#error Define ZB_ED_ROLE to compile sleepy end device source code.
+#endif
+#elif !defined(ZB_ROUTER_ROLE)
 #error Define ZB_ROUTER_ROLE to compile router source code.
 #endif
 
@@ -97,12 +113,14 @@ typedef struct {
 	zb_zcl_identify_attrs_t identify_attr;
 	zb_zcl_scenes_attrs_t scenes_attr;
 	zb_zcl_groups_attrs_t groups_attr;
-	zb_zcl_on_off_attrs_t on_off_attr;
 } bulb_device_ctx_t;
 
 /* Zigbee device application context storage. */
 static bulb_device_ctx_t dev_ctx;
 
+/* Whether the coordinator answered a time read, only used in the Zigbee thread. */
+static zb_bool_t time_synced;
+
 ZB_ZCL_DECLARE_IDENTIFY_ATTRIB_LIST(
 	identify_attr_list,
 	&dev_ctx.identify_attr.identify_time);
@@ -133,18 +151,51 @@ ZB_ZCL_DECLARE_BASIC_ATTRIB_LIST_EXT(
 	&dev_ctx.basic_attr.ph_env,
 	dev_ctx.basic_attr.sw_ver);
 
-/* On/Off cluster attributes additions data */
+/* On/Off cluster attributes additions data, the door clusters live in coop_zcl.c */
 ZB_ZCL_DECLARE_ON_OFF_ATTRIB_LIST(
 	on_off_attr_list,
-	&dev_ctx.on_off_attr.on_off);
-
-ZB_DECLARE_CHICKEN_COOP_CLUSTER_LIST(
-	chicken_coop_clusters,
-	basic_attr_list,
-	identify_attr_list,
-	groups_attr_list,
-	scenes_attr_list,
-	on_off_attr_list);
+	&coop_zcl_ctx.on_off_attr.on_off);
+
+ZB_ZCL_DECLARE_WINDOW_COVERING_CLUSTER_ATTRIB_LIST(
+	window_covering_attr_list,
+	&coop_zcl_ctx.window_covering_attr.window_covering_type,
+	&coop_zcl_ctx.window_covering_attr.config_status,
+	&coop_zcl_ctx.window_covering_attr.current_position_lift_percentage,
+	&coop_zcl_ctx.window_covering_attr.current_position_tilt_percentage,
+	&coop_zcl_ctx.window_covering_attr.installed_open_limit_lift,
+	&coop_zcl_ctx.window_covering_attr.installed_closed_limit_lift,
+	&coop_zcl_ctx.window_covering_attr.installed_open_limit_tilt,
+	&coop_zcl_ctx.window_covering_attr.installed_closed_limit_tilt,
+	&coop_zcl_ctx.window_covering_attr.mode);
+
+ZB_ZCL_DECLARE_COOP_CONFIG_ATTRIB_LIST(
+	coop_config_attr_list,
+	&coop_zcl_ctx.coop_config_attr.travel_steps,
+	&coop_zcl_ctx.coop_config_attr.cruise_speed,
+	&coop_zcl_ctx.coop_config_attr.acceleration,
+	&coop_zcl_ctx.coop_config_attr.hold_timeout,
+	&coop_zcl_ctx.coop_config_attr.door_state,
+	&coop_zcl_ctx.coop_config_attr.position_error,
+	&coop_zcl_ctx.coop_config_attr.schedule_enabled,
+	&coop_zcl_ctx.coop_config_attr.latitude,
+	&coop_zcl_ctx.coop_config_attr.longitude,
+	&coop_zcl_ctx.coop_config_attr.sunrise_offset,
+	&coop_zcl_ctx.coop_config_attr.sunset_offset,
+	&coop_zcl_ctx.coop_config_attr.light_control,
+	&coop_zcl_ctx.coop_config_attr.dawn_level,
+	&coop_zcl_ctx.coop_config_attr.dusk_level,
+	&coop_zcl_ctx.coop_config_attr.boot_time,
+	&coop_zcl_ctx.coop_config_attr.step_jitter);
+
+ZB_ZCL_DECLARE_ILLUMINANCE_MEASUREMENT_ATTRIB_LIST(
+	illuminance_attr_list,
+	&coop_zcl_ctx.illuminance_attr.measured_value,
+	&coop_zcl_ctx.illuminance_attr.min_measured_value,
+	&coop_zcl_ctx.illuminance_attr.max_measured_value);
+
+ZB_ZCL_DECLARE_ALARMS_ATTRIB_LIST(alarms_attr_list);
+
+ZB_DECLARE_CHICKEN_COOP_CLUSTER_LIST(chicken_coop_clusters);
 
 
 ZB_DECLARE_CHICKEN_COOP_EP(
@@ -214,6 +265,10 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 		}
 	}
 
+	if ((CALIBRATE_BUTTON & has_changed) && !(CALIBRATE_BUTTON & button_state)) {
+		ZB_SCHEDULE_APP_CALLBACK(coop_zcl_calibrate, 0);
+	}
+
 	check_factory_reset_button(button_state, has_changed);
 }
 
@@ -227,69 +282,47 @@ static void configure_gpio(void)
 		LOG_ERR("Cannot init buttons (err: %d)", err);
 	}
 
-	err = dk_leds_init();
+	err = led_init();
 	if (err) {
 		LOG_ERR("Cannot init LEDs (err: %d)", err);
 	}
 }
 
-/**@brief Function for turning ON/OFF the light bulb.
+/**@brief Function to handle identify notification events on the first endpoint.
  *
- * @param[in]   on   Boolean light bulb state.
+ * @param  bufid  Non-zero when identification starts, zero when it ends.
  */
-static void on_off_set_value(zb_bool_t on)
+static void identify_cb(zb_bufid_t bufid)
 {
-	LOG_INF("Set ON/OFF value: %i", on);
-
-	ZB_ZCL_SET_ATTRIBUTE(
-		CHICKEN_COOP_ENDPOINT,
-		ZB_ZCL_CLUSTER_ID_ON_OFF,
-		ZB_ZCL_CLUSTER_SERVER_ROLE,
-		ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
-		(zb_uint8_t *)&on,
-		ZB_FALSE);
-
-	if (on) {
-		stepper_run(true);
-	} else {
-		stepper_run(false);
-	}
+	/* Blinking is done by the LED PWM, nothing to schedule here. */
+	led_pattern_set(LED_IDENTIFY, bufid ? LED_PATTERN_BLINK : LED_PATTERN_OFF);
 }
 
-/**@brief Function to toggle the identify LED - BULB_LED is used for this.
+/**@brief Function for showing the network state on the network LED.
  *
- * @param  bufid  Unused parameter, required by ZBOSS scheduler API.
- */
-static void toggle_identify_led(zb_bufid_t bufid)
-{
-	static int blink_status;
-
-	dk_set_led(IDENTIFY_LED, (++blink_status) % 2);
-	
-	ZB_SCHEDULE_APP_ALARM(toggle_identify_led, bufid, ZB_MILLISECONDS_TO_BEACON_INTERVAL(100));
-}
-
-/**@brief Function to handle identify notification events on the first endpoint.
+ * Same behavior as zigbee_led_status_update(), using the LED PWM.
  *
- * @param  bufid  Unused parameter, required by ZBOSS scheduler API.
+ * @param[in]   sig      Signal received from the stack.
+ * @param[in]   status   Status of the signal.
  */
-static void identify_cb(zb_bufid_t bufid)
+static void network_led_update(zb_zdo_app_signal_type_t sig, zb_ret_t status)
 {
-	zb_ret_t zb_err_code;
-
-	if (bufid) {
-		/* Schedule a self-scheduling function that will toggle the LED. */
-		ZB_SCHEDULE_APP_CALLBACK(toggle_identify_led, bufid);
-	} else {
-		/* Cancel the toggling function alarm and restore current Zigbee LED state. */
-		zb_err_code = ZB_SCHEDULE_APP_ALARM_CANCEL(toggle_identify_led, ZB_ALARM_ANY_PARAM);
-		ZVUNUSED(zb_err_code);
-
-		dk_set_led(IDENTIFY_LED, 0);
+	switch (sig) {
+	case ZB_BDB_SIGNAL_DEVICE_REBOOT:
+	case ZB_BDB_SIGNAL_STEERING:
+		led_pattern_set(LED_NETWORK, status == RET_OK ? LED_PATTERN_ON : LED_PATTERN_OFF);
+		break;
+	case ZB_ZDO_SIGNAL_LEAVE:
+		if (status == RET_OK) {
+			led_pattern_set(LED_NETWORK, LED_PATTERN_OFF);
+		}
+		break;
+	default:
+		break;
 	}
 }
 
-/**@brief Function for initializing all clusters attributes.
+/**@brief Function for initializing the attributes of the clusters not driven by the door.
  */
 static void bulb_clusters_attr_init(void)
 {
@@ -332,17 +365,140 @@ static void bulb_clusters_attr_init(void)
 	/* Identify cluster attributes data. */
 	dev_ctx.identify_attr.identify_time =
 		ZB_ZCL_IDENTIFY_IDENTIFY_TIME_DEFAULT_VALUE;
+}
 
-	/* On/Off cluster attributes data. */
-	dev_ctx.on_off_attr.on_off = (zb_bool_t)ZB_ZCL_ON_OFF_IS_ON;
+/**@brief Function for handling the commands of the coop configuration cluster.
+ *
+ * @param[in]   bufid   Reference to Zigbee stack buffer holding the command.
+ *
+ * @return ZB_TRUE if the command was handled.
+ */
+static zb_bool_t coop_config_cmd_handler(zb_uint8_t bufid)
+{
+	zb_zcl_parsed_hdr_t cmd_info;
+	zb_uint8_t status;
+
+	ZB_ZCL_COPY_PARSED_HEADER(bufid, &cmd_info);
+
+	if (cmd_info.is_common_command ||
+	    cmd_info.cmd_direction != ZB_ZCL_FRAME_DIRECTION_TO_SRV ||
+	    !cmd_info.is_manuf_specific ||
+	    cmd_info.manuf_specific != ZB_ZCL_COOP_CONFIG_MANUF_CODE) {
+		return ZB_FALSE;
+	}
+
+	switch (cmd_info.cmd_id) {
+	case ZB_ZCL_CMD_COOP_CONFIG_CALIBRATE_ID:
+		coop_zcl_calibrate(0);
+		status = ZB_ZCL_STATUS_SUCCESS;
+		break;
+	default:
+		return ZB_FALSE;
+	}
 
-	ZB_ZCL_SET_ATTRIBUTE(
-		CHICKEN_COOP_ENDPOINT,
-		ZB_ZCL_CLUSTER_ID_ON_OFF,
-		ZB_ZCL_CLUSTER_SERVER_ROLE,
-		ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
-		(zb_uint8_t *)&dev_ctx.on_off_attr.on_off,
-		ZB_FALSE);
+	ZB_ZCL_PROCESS_COMMAND_FINISH(bufid, &cmd_info, status);
+
+	return ZB_TRUE;
+}
+
+void zb_zcl_coop_config_init_server(void)
+{
+	zb_zcl_add_cluster_handlers(ZB_ZCL_CLUSTER_ID_COOP_CONFIG,
+				    ZB_ZCL_CLUSTER_SERVER_ROLE,
+				    coop_zcl_config_check_value,
+				    coop_zcl_config_write,
+				    coop_config_cmd_handler);
+}
+
+/**@brief Function for reading the Time attribute of the coordinator.
+ *
+ * The answer is handled by coop_ep_handler().
+ *
+ * @param[in]   bufid   Buffer to send the request with.
+ */
+static void time_sync_request(zb_bufid_t bufid)
+{
+	zb_uint8_t *cmd_ptr;
+	zb_uint16_t addr = TIME_SERVER_ADDR;
+
+	ZB_ZCL_GENERAL_INIT_READ_ATTR_REQ(bufid, cmd_ptr, ZB_ZCL_DISABLE_DEFAULT_RESPONSE);
+	ZB_ZCL_GENERAL_ADD_ID_READ_ATTR_REQ(cmd_ptr, ZB_ZCL_ATTR_TIME_TIME_ID);
+	ZB_ZCL_GENERAL_SEND_READ_ATTR_REQ(bufid, cmd_ptr, addr,
+					  ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+					  CONFIG_CHICKEN_COOP_TIME_SERVER_ENDPOINT,
+					  CHICKEN_COOP_ENDPOINT, ZB_AF_HA_PROFILE_ID,
+					  ZB_ZCL_CLUSTER_ID_TIME, NULL);
+}
+
+/**@brief Function for reading the time now and again later.
+ *
+ * Retried every minute until the coordinator answered, then only to correct
+ * the drift of the local clock.
+ *
+ * @param[in]   param   Unused parameter, required by ZBOSS scheduler API.
+ */
+static void time_sync(zb_uint8_t param)
+{
+	zb_uint32_t interval = time_synced ? CONFIG_CHICKEN_COOP_TIME_SYNC_INTERVAL :
+					     TIME_SYNC_RETRY_INTERVAL;
+	zb_ret_t zb_err_code;
+
+	ZVUNUSED(param);
+
+	zb_err_code = zb_buf_get_out_delayed(time_sync_request);
+	if (zb_err_code != RET_OK) {
+		LOG_WRN("Cannot request the time (err: %d)", zb_err_code);
+	}
+
+	ZB_SCHEDULE_APP_ALARM(time_sync, 0, ZB_TIME_ONE_SECOND * interval);
+}
+
+/**@brief Function for starting the time sync once joined.
+ *
+ * Restarts the sync if it was already running, so rejoins do not stack alarms.
+ */
+static void time_sync_start(void)
+{
+	ZB_SCHEDULE_APP_ALARM_CANCEL(time_sync, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_CALLBACK(time_sync, 0);
+}
+
+/**@brief Endpoint handler, catching the answers to time_sync_request().
+ *
+ * @param[in]   bufid   Reference to Zigbee stack buffer used to pass received data.
+ *
+ * @return ZB_TRUE if the command was handled and the buffer freed.
+ */
+static zb_uint8_t coop_ep_handler(zb_bufid_t bufid)
+{
+	zb_zcl_parsed_hdr_t *cmd_info = ZB_BUF_GET_PARAM(bufid, zb_zcl_parsed_hdr_t);
+	zb_zcl_read_attr_res_t *resp;
+
+	diag_buf_sample();
+
+	if (cmd_info->cluster_id != ZB_ZCL_CLUSTER_ID_TIME ||
+	    !cmd_info->is_common_command ||
+	    cmd_info->cmd_id != ZB_ZCL_CMD_READ_ATTRIB_RESP) {
+		return ZB_FALSE;
+	}
+
+	ZB_ZCL_GENERAL_GET_NEXT_READ_ATTR_RES(bufid, resp);
+	if (resp && resp->status == ZB_ZCL_STATUS_SUCCESS &&
+	    resp->attr_id == ZB_ZCL_ATTR_TIME_TIME_ID) {
+		zb_uint32_t zcl_time = sys_get_le32(resp->attr_value);
+
+		if (zcl_time != ZB_ZCL_TIME_TIME_INVALID_VALUE) {
+			LOG_INF("Time synced: %u", zcl_time);
+			schedule_time_set(zcl_time + ZCL_TIME_EPOCH_UNIX);
+			time_synced = ZB_TRUE;
+		}
+	} else {
+		LOG_WRN("Coordinator has no valid time");
+	}
+
+	zb_buf_free(bufid);
+
+	return ZB_TRUE;
 }
 
 /**@brief Callback function for handling ZCL commands.
@@ -352,48 +508,29 @@ static void bulb_clusters_attr_init(void)
  */
 static void zcl_device_cb(zb_bufid_t bufid)
 {
-	zb_uint8_t cluster_id;
-	zb_uint8_t attr_id;
 	zb_zcl_device_callback_param_t  *device_cb_param =
 		ZB_BUF_GET_PARAM(bufid, zb_zcl_device_callback_param_t);
 
-	LOG_INF("%s id %hd", __func__, device_cb_param->device_cb_id);
-
-	/* Set default response value. */
-	device_cb_param->status = RET_OK;
-
-	switch (device_cb_param->device_cb_id) {
-	case ZB_ZCL_SET_ATTR_VALUE_CB_ID:
-		cluster_id = device_cb_param->cb_param.
-			     set_attr_value_param.cluster_id;
-		attr_id = device_cb_param->cb_param.
-			  set_attr_value_param.attr_id;
-
-		if (cluster_id == ZB_ZCL_CLUSTER_ID_ON_OFF) {
-			uint8_t value =
-				device_cb_param->cb_param.set_attr_value_param
-				.values.data8;
+	/* The door clusters are decoded by coop_zcl.c, the rest are scenes. */
+	if (coop_zcl_device_cb(device_cb_param)) {
+		return;
+	}
 
-			LOG_INF("on/off attribute setting to %hd", value);
-			if (attr_id == ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID) {
-				on_off_set_value((zb_bool_t)value);
-			}
-		} else {
-			/* Other clusters can be processed here */
-			LOG_INF("Unhandled cluster attribute id: %d",
-				cluster_id);
-			device_cb_param->status = RET_NOT_IMPLEMENTED;
-		}
-		break;
+	device_cb_param->status = zcl_scenes_cb(bufid) ? RET_OK : RET_NOT_IMPLEMENTED;
+	LOG_INF("%s status: %hd", __func__, device_cb_param->status);
+}
 
-	default:
-		if (zcl_scenes_cb(bufid) == ZB_FALSE) {
-			device_cb_param->status = RET_NOT_IMPLEMENTED;
-		}
-		break;
+/**@brief Publish the time from reset to joined, once per boot. */
+static void boot_time_joined(void)
+{
+	if (boot_time_get(BOOT_PHASE_JOINED)) {
+		return;
 	}
 
-	LOG_INF("%s status: %hd", __func__, device_cb_param->status);
+	boot_time_mark(BOOT_PHASE_JOINED);
+	coop_zcl_ctx.coop_config_attr.boot_time = boot_time_get(BOOT_PHASE_JOINED);
+
+	LOG_INF("Joined %u ms after reset", coop_zcl_ctx.coop_config_attr.boot_time);
 }
 
 /**@brief Zigbee stack event handler.
@@ -403,12 +540,36 @@ static void zcl_device_cb(zb_bufid_t bufid)
  */
 void zboss_signal_handler(zb_bufid_t bufid)
 {
+	zb_zdo_app_signal_hdr_t *sig_hndler = NULL;
+	zb_zdo_app_signal_type_t sig = zb_get_app_signal(bufid, &sig_hndler);
+	zb_ret_t status = ZB_GET_APP_SIGNAL_STATUS(bufid);
+
+	/* The first signal comes once the stack has read its NVRAM. */
+	boot_time_mark(BOOT_PHASE_STACK_STARTED);
+
+	diag_buf_sample();
+
 	/* Update network status LED. */
-	zigbee_led_status_update(bufid, ZIGBEE_NETWORK_STATE_LED);
+	network_led_update(sig, status);
+
+	switch (sig) {
+	case ZB_BDB_SIGNAL_DEVICE_REBOOT:
+	case ZB_BDB_SIGNAL_STEERING:
+		if (status == RET_OK) {
+			boot_time_joined();
+			rejoin_network_joined();
+			sleepy_network_joined(CHICKEN_COOP_ENDPOINT);
+			time_sync_start();
+			diag_network_joined();
+		} else if (sig == ZB_BDB_SIGNAL_STEERING) {
+			rejoin_steering_failed();
+		}
+		break;
+	default:
+		break;
+	}
 
-	/* No application-specific behavior is required.
-	 * Call default signal handler.
-	 */
+	/* Call default signal handler for the rest of the behavior. */
 	ZB_ERROR_CHECK(zigbee_default_signal_handler(bufid));
 
 	/* All callbacks should either reuse or free passed buffers.
@@ -421,9 +582,10 @@ void zboss_signal_handler(zb_bufid_t bufid)
 
 int main(void)
 {
-	int blink_status = 0;
 	int err;
 
+	boot_time_mark(BOOT_PHASE_MAIN);
+
 	LOG_INF("Starting Chicken coop");
 
 	/* Initialize */
@@ -432,6 +594,7 @@ int main(void)
 	if (err) {
 		LOG_ERR("settings initialization failed");
 	}
+	boot_time_mark(BOOT_PHASE_SETTINGS_INIT);
 	register_factory_reset_button(FACTORY_RESET_BUTTON);
 
 	/* Register callback for handling ZCL commands. */
@@ -442,27 +605,57 @@ int main(void)
 
 	bulb_clusters_attr_init();
 
+	/* Door clusters, their reporting and the callbacks moving the door. */
+	coop_zcl_init();
+
+	ZB_AF_SET_ENDPOINT_HANDLER(CHICKEN_COOP_ENDPOINT, coop_ep_handler);
+
 	/* Register handler to identify notifications. */
 	ZB_AF_SET_IDENTIFY_NOTIFICATION_HANDLER(CHICKEN_COOP_ENDPOINT, identify_cb);
 
 	/* Initialize ZCL scene table */
 	zcl_scenes_init();
+	boot_time_mark(BOOT_PHASE_SCENES_INIT);
 
 	/* Settings should be loaded after zcl_scenes_init */
 	err = settings_load();
 	if (err) {
 		LOG_ERR("settings loading failed");
 	}
+	boot_time_mark(BOOT_PHASE_SETTINGS_LOADED);
+
+	coop_zcl_config_attr_init();
+
+	/* The door needs its travel from settings before it moves. */
+	motion_start();
+
+	/* Light sampling needs the dusk and dawn levels from settings. */
+	err = light_init();
+	if (err) {
+		LOG_ERR("Cannot init light sensor (err: %d)", err);
+	}
+
+	/* A sleepy coop must be configured before the stack starts. */
+	sleepy_init();
+
+#ifdef CONFIG_ZIGBEE_ROLE_ROUTER
+	zb_set_max_children(CONFIG_CHICKEN_COOP_MAX_CHILDREN);
+#endif
+
+	/* Look for the last network first, needs it from settings. */
+	rejoin_prepare();
 
 	/* Start Zigbee default thread */
 	zigbee_enable();
+	boot_time_mark(BOOT_PHASE_ZIGBEE_ENABLED);
 
 	LOG_INF("ZBOSS Light Bulb example started");
 
-	stepper_init();
-
-	while (1) {
-		dk_set_led(RUN_STATUS_LED, (++blink_status) % 2);
-		k_sleep(K_MSEC(RUN_LED_BLINK_INTERVAL));
+	/* The heartbeat keeps the PWM and its clock running, a sleepy coop goes without. */
+	if (!IS_ENABLED(CONFIG_CHICKEN_COOP_SLEEPY)) {
+		led_pattern_set(LED_RUN, LED_PATTERN_HEARTBEAT);
 	}
+
+	/* Everything else runs in its own thread or in hardware. */
+	return 0;
 }
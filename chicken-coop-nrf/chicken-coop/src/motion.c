@@ -0,0 +1,665 @@
+#include "motion.h"
+#include "motion_config.h"
+#include "planner.h"
+#include "power_fail.h"
+#include "retained.h"
+#include "stepper.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(motion, LOG_LEVEL_INF);
+
+#define MOTION_THREAD_STACK_SIZE 1024
+#define MOTION_THREAD_PRIORITY 5
+#define MOTION_QUEUE_LEN 4
+
+/* Queued command, the lift percentage is only used by MOTION_CMD_GOTO. */
+struct motion_request {
+	enum motion_cmd cmd;
+	uint8_t lift_percent;
+};
+
+K_MSGQ_DEFINE(motion_queue, sizeof(struct motion_request), MOTION_QUEUE_LEN, 4);
+
+static K_SEM_DEFINE(move_done_sem, 0, 1);
+static K_SEM_DEFINE(start_sem, 0, 1);
+
+static enum stepper_result move_result;
+static uint32_t move_steps;
+static motion_position_cb_t position_cb;
+static motion_state_cb_t state_cb;
+static motion_stall_cb_t stall_cb;
+static motion_error_cb_t error_cb;
+
+static enum door_state state = DOOR_STATE_STOPPED;
+
+/* Move in progress. Homing has no target, it only gives way to a stop. Any
+ * command cancels a calibration.
+ */
+static int32_t move_target;
+static bool move_dir;
+static bool homing;
+static bool calibrating;
+
+/* Last lift percentage handed to position_cb. */
+static uint8_t reported_lift;
+
+/* Latest request received while a move was running. */
+static struct motion_request pending;
+static bool has_pending;
+
+int motion_submit(enum motion_cmd cmd, uint8_t lift_percent)
+{
+	struct motion_request req = {
+		.cmd = cmd,
+		.lift_percent = lift_percent,
+	};
+
+	if (cmd == MOTION_CMD_GOTO && lift_percent > 100) {
+		return -EINVAL;
+	}
+
+	/* Only the latest target matters, so make room instead of waiting. */
+	while (k_msgq_put(&motion_queue, &req, K_NO_WAIT) != 0) {
+		k_msgq_purge(&motion_queue);
+	}
+
+	return 0;
+}
+
+void motion_start(void)
+{
+	k_sem_give(&start_sem);
+}
+
+void motion_register_position_cb(motion_position_cb_t cb)
+{
+	position_cb = cb;
+}
+
+void motion_register_state_cb(motion_state_cb_t cb)
+{
+	state_cb = cb;
+}
+
+void motion_register_stall_cb(motion_stall_cb_t cb)
+{
+	stall_cb = cb;
+}
+
+void motion_register_error_cb(motion_error_cb_t cb)
+{
+	error_cb = cb;
+}
+
+enum door_state motion_state_get(void)
+{
+	return state;
+}
+
+static void state_set(enum door_state new_state)
+{
+	/* A reset mid-move must not trust the position from before the move. */
+	retained_door_set(stepper_position_get(),
+			  stepper_position_known() && new_state != DOOR_STATE_OPENING &&
+			  new_state != DOOR_STATE_CLOSING);
+
+	if (new_state == state) {
+		return;
+	}
+
+	LOG_INF("Door state %d -> %d", state, new_state);
+	state = new_state;
+
+	if (state_cb) {
+		state_cb(new_state);
+	}
+}
+
+static void move_done(uint32_t steps, enum stepper_result result)
+{
+	move_steps = steps;
+	move_result = result;
+	k_sem_give(&move_done_sem);
+}
+
+/* Lift percentage counts from open (0 %) to closed (100 %), the position from closed. */
+static int32_t lift_to_position(uint8_t lift_percent)
+{
+	int32_t travel = motion_config_get()->travel_steps;
+
+	return travel * (100 - lift_percent) / 100;
+}
+
+static uint8_t position_to_lift(int32_t position)
+{
+	int32_t travel = motion_config_get()->travel_steps;
+
+	position = CLAMP(position, 0, travel);
+
+	return 100 - (position * 100 + travel / 2) / travel;
+}
+
+static int32_t request_target(const struct motion_request *req)
+{
+	switch (req->cmd) {
+	case MOTION_CMD_OPEN:
+		return motion_config_get()->travel_steps;
+	case MOTION_CMD_CLOSE:
+		return 0;
+	default:
+		return lift_to_position(req->lift_percent);
+	}
+}
+
+/* A request received mid-move ramps the door down unless it keeps the target. */
+static void retarget(const struct motion_request *req)
+{
+	if (req->cmd == MOTION_CMD_STOP || req->cmd == MOTION_CMD_CALIBRATE || calibrating) {
+		stepper_decelerate();
+	} else if (!homing && request_target(req) != move_target) {
+		LOG_INF("New target, decelerating");
+		stepper_decelerate();
+	}
+}
+
+/* State once the door stands still. */
+static enum door_state state_at_rest(void)
+{
+	int32_t position = stepper_position_get();
+
+	if (move_result == STEPPER_ENDSTOP) {
+		return move_dir ? DOOR_STATE_OPEN : DOOR_STATE_CLOSED;
+	}
+
+	if (!stepper_position_known()) {
+		return DOOR_STATE_STOPPED;
+	}
+
+	if (position <= 0) {
+		return DOOR_STATE_CLOSED;
+	} else if (position >= motion_config_get()->travel_steps) {
+		return DOOR_STATE_OPEN;
+	}
+
+	return DOOR_STATE_STOPPED;
+}
+
+/* Publish the live position if it moved far enough since the last report. */
+static void report_progress(void)
+{
+	uint8_t lift;
+
+	if (!position_cb || !stepper_position_known()) {
+		return;
+	}
+
+	lift = position_to_lift(stepper_position_get());
+	if (abs(lift - reported_lift) < CONFIG_CHICKEN_COOP_REPORT_LIFT_CHANGE) {
+		return;
+	}
+
+	reported_lift = lift;
+	position_cb(lift, true);
+}
+
+/* Wait for the move to end while still taking in new commands, and sample
+ * the position in between.
+ */
+static void wait_for_move(void)
+{
+	struct k_poll_event events[] = {
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SEM_AVAILABLE,
+					 K_POLL_MODE_NOTIFY_ONLY, &move_done_sem),
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE,
+					 K_POLL_MODE_NOTIFY_ONLY, &motion_queue),
+	};
+
+	while (k_sem_take(&move_done_sem, K_NO_WAIT) != 0) {
+		if (k_poll(events, ARRAY_SIZE(events),
+			   K_MSEC(CONFIG_CHICKEN_COOP_REPORT_MOTION_INTERVAL)) == -EAGAIN) {
+			report_progress();
+			continue;
+		}
+		events[0].state = K_POLL_STATE_NOT_READY;
+		events[1].state = K_POLL_STATE_NOT_READY;
+
+		while (k_msgq_get(&motion_queue, &pending, K_NO_WAIT) == 0) {
+			has_pending = true;
+			retarget(&pending);
+		}
+	}
+}
+
+/* Report a stalled motor and back off whatever blocked the door while closing. */
+static int stall_recover(void)
+{
+	bool closing = !move_dir;
+
+	LOG_WRN("Door %s after %u steps", closing ? "obstructed" : "stalled", move_steps);
+
+	if (stall_cb) {
+		stall_cb(closing);
+	}
+
+	if (IS_ENABLED(CONFIG_CHICKEN_COOP_STALL_REVERSE) && closing && move_steps) {
+		move_dir = true;
+		if (stepper_move_async(move_steps, true, move_done) == 0) {
+			state_set(DOOR_STATE_OPENING);
+			wait_for_move();
+		}
+	}
+
+	return -EIO;
+}
+
+static int home(void)
+{
+	int err;
+
+	LOG_INF("Homing door");
+
+	move_dir = false;
+	move_result = STEPPER_ENDSTOP;
+
+	/* Allow for some slack, the endstop must be found within the travel. */
+	err = stepper_home(2 * motion_config_get()->travel_steps, move_done);
+	if (err == -EALREADY) {
+		return 0;
+	} else if (err) {
+		return err;
+	}
+
+	homing = true;
+	state_set(DOOR_STATE_CLOSING);
+	wait_for_move();
+	homing = false;
+
+	switch (move_result) {
+	case STEPPER_ENDSTOP:
+		return 0;
+	case STEPPER_STOPPED:
+		return -ECANCELED;
+	case STEPPER_STALL:
+		return stall_recover();
+	default:
+		return -EIO;
+	}
+}
+
+/* Returns -EALREADY if the door did not have to move. */
+static int move_once(int32_t target)
+{
+	int32_t position = stepper_position_get();
+	bool dir = target > position;
+	int err;
+
+	move_target = target;
+	move_dir = dir;
+	move_result = STEPPER_DONE;
+
+	if (target == position) {
+		return -EALREADY;
+	}
+
+	err = stepper_move_async(dir ? target - position : position - target, dir, move_done);
+	if (err == -EALREADY) {
+		move_result = STEPPER_ENDSTOP;
+		return err;
+	} else if (err) {
+		return err;
+	}
+
+	state_set(dir ? DOOR_STATE_OPENING : DOOR_STATE_CLOSING);
+	wait_for_move();
+
+	if (move_result == STEPPER_STALL) {
+		return stall_recover();
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_CHICKEN_COOP_ENCODER
+/* Hand the encoder measurement of the last move out, flagging drift. */
+static void error_check(void)
+{
+	int32_t error = stepper_position_error();
+	bool drift = abs(error) > CONFIG_CHICKEN_COOP_ENCODER_DRIFT_LIMIT;
+
+	if (drift) {
+		LOG_WRN("Door lost %d steps", abs(error));
+	}
+
+	if (error_cb) {
+		error_cb(error, drift);
+	}
+}
+
+/* The position follows the encoder, finish a move that lost steps. */
+static int move_correct(int32_t target)
+{
+	int err;
+
+	error_check();
+
+	if (move_result != STEPPER_DONE || has_pending ||
+	    abs(target - stepper_position_get()) <= CONFIG_CHICKEN_COOP_ENCODER_TOLERANCE) {
+		return 0;
+	}
+
+	LOG_INF("Correcting door by %d steps", target - stepper_position_get());
+
+	err = move_once(target);
+	if (err == -EALREADY) {
+		return 0;
+	} else if (!err) {
+		error_check();
+	}
+
+	return err;
+}
+#endif
+
+static int move_to(int32_t target)
+{
+	int err = move_once(target);
+
+	if (err == -EALREADY) {
+		return 0;
+	}
+
+#ifdef CONFIG_CHICKEN_COOP_ENCODER
+	if (!err) {
+		err = move_correct(target);
+	}
+#endif
+
+	return err;
+}
+
+static int profile_apply(uint32_t cruise_speed)
+{
+	return planner_configure(CONFIG_CHICKEN_COOP_START_SPEED, cruise_speed,
+				 motion_config_get()->acceleration, CONFIG_CHICKEN_COOP_JERK);
+}
+
+/* Rebuild the ramp if its parameters changed. Only done between moves. */
+static void profile_update(void)
+{
+	if (!motion_config_profile_changed()) {
+		return;
+	}
+
+	int err = profile_apply(motion_config_get()->cruise_speed);
+
+	if (err) {
+		LOG_ERR("Cannot apply speed profile (err: %d)", err);
+	}
+}
+
+/* Run from one endstop to the other at the speed under test. Steps lost on
+ * the way show as extra steps before the endstop, or as a missed endstop.
+ */
+static int calibration_run(int32_t travel, bool dir)
+{
+	int32_t lost;
+	int err;
+
+	move_target = dir ? travel : 0;
+	move_dir = dir;
+
+	err = stepper_move_async(travel + CONFIG_CHICKEN_COOP_CALIBRATION_TOLERANCE, dir,
+				 move_done);
+	if (err) {
+		return err;
+	}
+
+	state_set(dir ? DOOR_STATE_OPENING : DOOR_STATE_CLOSING);
+	wait_for_move();
+
+	if (has_pending) {
+		return -ECANCELED;
+	}
+
+	/* A failed run leaves the door somewhere short of the endstop, with
+	 * the full run counted. Only homing tells where it is.
+	 */
+	if (move_result == STEPPER_STALL) {
+		LOG_INF("Motor stalled");
+		stepper_position_forget();
+		return -EIO;
+	} else if (move_result != STEPPER_ENDSTOP) {
+		LOG_INF("Endstop not reached");
+		stepper_position_forget();
+		return -EIO;
+	}
+
+	lost = (int32_t)move_steps - travel;
+	if (IS_ENABLED(CONFIG_CHICKEN_COOP_ENCODER) && abs(stepper_position_error()) > abs(lost)) {
+		lost = stepper_position_error();
+	}
+
+	if (abs(lost) > CONFIG_CHICKEN_COOP_CALIBRATION_TOLERANCE) {
+		LOG_INF("Lost %d steps", abs(lost));
+		stepper_position_forget();
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Home, measure the travel between the endstops at start speed, then raise
+ * the cruise speed until the door loses steps or stalls. The travel and the
+ * fastest reliable speed less the margin are stored.
+ */
+static int calibrate(void)
+{
+	uint32_t speed;
+	uint32_t best = 0;
+	int32_t travel;
+	int err;
+
+	LOG_INF("Calibrating door");
+
+	err = home();
+	if (err) {
+		return err;
+	}
+
+	move_dir = true;
+	err = stepper_seek(true, UINT16_MAX, move_done);
+	if (err) {
+		return err;
+	}
+
+	state_set(DOOR_STATE_OPENING);
+	wait_for_move();
+
+	if (has_pending) {
+		return -ECANCELED;
+	} else if (move_result != STEPPER_ENDSTOP) {
+		LOG_ERR("Open endstop not found");
+		return -EIO;
+	}
+
+	travel = stepper_position_get();
+	LOG_INF("Travel %d steps", travel);
+
+	if (travel < 1 || travel > UINT16_MAX) {
+		return -EIO;
+	}
+
+	for (speed = CONFIG_CHICKEN_COOP_START_SPEED; speed <= MOTION_CONFIG_CRUISE_SPEED_MAX;
+	     speed += CONFIG_CHICKEN_COOP_CALIBRATION_SPEED_STEP) {
+		LOG_INF("Trying %u steps/s", speed);
+
+		err = profile_apply(speed);
+		if (!err) {
+			err = calibration_run(travel, false);
+		}
+		if (!err) {
+			err = calibration_run(travel, true);
+		}
+		if (err) {
+			break;
+		}
+
+		best = speed;
+	}
+
+	/* Back to the stored profile, or the new one below. */
+	profile_apply(motion_config_get()->cruise_speed);
+
+	if (err == -ECANCELED) {
+		return err;
+	} else if (!best) {
+		LOG_ERR("Door does not even run at start speed");
+		return -EIO;
+	}
+
+	best = MAX(best * (100 - CONFIG_CHICKEN_COOP_CALIBRATION_MARGIN) / 100,
+		   CONFIG_CHICKEN_COOP_START_SPEED);
+	LOG_INF("Calibrated travel %d steps, cruise speed %u steps/s", travel, best);
+
+	motion_config_set(MOTION_CONFIG_TRAVEL_STEPS, travel);
+	motion_config_set(MOTION_CONFIG_CRUISE_SPEED, best);
+	profile_update();
+
+	/* A failed run may have cost the position, find it again. */
+	if (!stepper_position_known()) {
+		return home();
+	}
+
+	return 0;
+}
+
+static void motion_thread(void *p1, void *p2, void *p3)
+{
+	struct motion_request req;
+	struct motion_request next;
+	k_timeout_t release_at = K_FOREVER;
+	const struct retained_door *door = retained_door_get();
+	int32_t position;
+	int err;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	err = stepper_init();
+	if (err) {
+		LOG_ERR("Cannot init stepper (err: %d)", err);
+		return;
+	}
+
+	/* No homing after a reset or a power failure, the door is where it was
+	 * left. RAM kept across a warm reset is more recent than the flash record.
+	 */
+	err = power_fail_init(&position);
+	if (door) {
+		if (door->position_known) {
+			stepper_position_restore(door->position);
+		}
+	} else if (!err) {
+		stepper_position_restore(position);
+	}
+
+	/* The travel is only known once the settings are loaded. */
+	k_sem_take(&start_sem, K_FOREVER);
+
+	if (stepper_position_known()) {
+		state_set(state_at_rest());
+
+		if (position_cb) {
+			reported_lift = position_to_lift(stepper_position_get());
+			position_cb(reported_lift, false);
+		}
+	}
+
+	while (1) {
+		if (has_pending) {
+			req = pending;
+			has_pending = false;
+		} else if (k_msgq_get(&motion_queue, &req, release_at) != 0) {
+			/* Nothing new while holding the door, let the motor rest. */
+			stepper_release();
+			release_at = K_FOREVER;
+			continue;
+		}
+
+		/* Collapse everything that arrived during the last move. */
+		while (k_msgq_get(&motion_queue, &next, K_NO_WAIT) == 0) {
+			req = next;
+		}
+
+		if (req.cmd == MOTION_CMD_STOP) {
+			continue;
+		}
+
+		power_fail_rearm();
+		profile_update();
+
+		/* Without a known position the door is homed first, afterwards
+		 * only the remaining distance to the target is travelled.
+		 */
+		if (!stepper_position_known()) {
+			err = home();
+			if (err == -ECANCELED) {
+				state_set(DOOR_STATE_STOPPED);
+				stepper_release();
+				continue;
+			} else if (err) {
+				LOG_ERR("Homing failed (err: %d)", err);
+				state_set(DOOR_STATE_FAULT);
+				stepper_release();
+				continue;
+			}
+		}
+
+		if (req.cmd == MOTION_CMD_CALIBRATE) {
+			calibrating = true;
+			err = calibrate();
+			calibrating = false;
+			if (err == -ECANCELED) {
+				LOG_INF("Calibration cancelled");
+				err = 0;
+			} else if (err) {
+				LOG_ERR("Calibration failed (err: %d)", err);
+			}
+		} else {
+			LOG_INF("Moving door from %d to %d", stepper_position_get(),
+				request_target(&req));
+
+			err = move_to(request_target(&req));
+			if (err) {
+				LOG_ERR("Cannot move door (err: %d)", err);
+			}
+		}
+
+		if (err) {
+			state_set(DOOR_STATE_FAULT);
+		} else {
+			state_set(state_at_rest());
+		}
+
+		/* Always report the final position, even below the reportable change. */
+		if (position_cb && stepper_position_known()) {
+			reported_lift = position_to_lift(stepper_position_get());
+			position_cb(reported_lift, false);
+		}
+
+		if (motion_config_get()->hold_timeout) {
+			release_at = K_TIMEOUT_ABS_MS(k_uptime_get() +
+						      motion_config_get()->hold_timeout);
+		} else {
+			stepper_release();
+		}
+	}
+}
+
+K_THREAD_DEFINE(motion_tid, MOTION_THREAD_STACK_SIZE, motion_thread, NULL, NULL, NULL,
+		MOTION_THREAD_PRIORITY, 0, 0);
@@ -0,0 +1,103 @@
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Commands accepted by the motion thread. */
+enum motion_cmd {
+	MOTION_CMD_OPEN,
+	MOTION_CMD_CLOSE,
+	MOTION_CMD_STOP,
+	MOTION_CMD_GOTO,
+	/* Measure the travel and the fastest reliable cruise speed, and store them. */
+	MOTION_CMD_CALIBRATE,
+};
+
+/* States of the door. */
+enum door_state {
+	DOOR_STATE_CLOSED,
+	DOOR_STATE_OPENING,
+	DOOR_STATE_OPEN,
+	DOOR_STATE_CLOSING,
+	/* Halted between the endstops, or position unknown. */
+	DOOR_STATE_STOPPED,
+	/* Homing or the last move failed. Cleared by the next command. */
+	DOOR_STATE_FAULT,
+};
+
+/**@brief Callback reporting every door state transition.
+ *
+ * Called from the motion thread.
+ *
+ * @param[in]   state   New state.
+ */
+typedef void (*motion_state_cb_t)(enum door_state state);
+
+/**@brief Callback reporting the door position.
+ *
+ * Called from the motion thread while the door moves, at most every
+ * CONFIG_CHICKEN_COOP_REPORT_MOTION_INTERVAL and only once the lift changed
+ * by CONFIG_CHICKEN_COOP_REPORT_LIFT_CHANGE, then once more when it stopped.
+ *
+ * @param[in]   lift_percent   Position as ZCL lift percentage, 0 is open and 100 is closed.
+ * @param[in]   moving         False for the final position of a move.
+ */
+typedef void (*motion_position_cb_t)(uint8_t lift_percent, bool moving);
+
+/**@brief Callback reporting a stalled motor, the door is then in DOOR_STATE_FAULT.
+ *
+ * Called from the motion thread. A door blocked while closing is backed off
+ * to where its move started if CONFIG_CHICKEN_COOP_STALL_REVERSE is set.
+ *
+ * @param[in]   closing   True if the door was blocked while closing.
+ */
+typedef void (*motion_stall_cb_t)(bool closing);
+
+/**@brief Callback reporting the position error measured by the encoder after a move.
+ *
+ * Called from the motion thread, only with CONFIG_CHICKEN_COOP_ENCODER. A
+ * move that ended more than CONFIG_CHICKEN_COOP_ENCODER_TOLERANCE steps off
+ * its target is finished once more from the measured position.
+ *
+ * @param[in]   error_steps   Encoder position minus step count over the move.
+ * @param[in]   drift         True if more than CONFIG_CHICKEN_COOP_ENCODER_DRIFT_LIMIT
+ *                            steps were lost.
+ */
+typedef void (*motion_error_cb_t)(int32_t error_steps, bool drift);
+
+/**@brief Queue a command for the motion thread.
+ *
+ * Never blocks, so it is safe to call from the Zigbee stack thread.
+ * Commands that have not been started yet are superseded by newer ones,
+ * only the latest target is executed. A new target received while the door
+ * moves decelerates it, then the door heads for the new target from where
+ * it stopped. MOTION_CMD_STOP decelerates the door as well. Any command
+ * received during MOTION_CMD_CALIBRATE cancels the calibration.
+ *
+ * @param[in]   cmd            Command to execute.
+ * @param[in]   lift_percent   Target of MOTION_CMD_GOTO, 0 is open and 100 is closed.
+ *
+ * @retval 0        Command queued.
+ * @retval -EINVAL  Lift percentage out of range.
+ */
+int motion_submit(enum motion_cmd cmd, uint8_t lift_percent);
+
+/**@brief Let the motion thread run, once the settings are loaded.
+ *
+ * Commands submitted before are queued. A position restored at boot is
+ * reported through the callbacks from here on.
+ */
+void motion_start(void);
+
+void motion_register_position_cb(motion_position_cb_t cb);
+
+void motion_register_state_cb(motion_state_cb_t cb);
+
+void motion_register_stall_cb(motion_stall_cb_t cb);
+
+void motion_register_error_cb(motion_error_cb_t cb);
+
+enum door_state motion_state_get(void);
+
+#endif
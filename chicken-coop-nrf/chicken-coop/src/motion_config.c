@@ -0,0 +1,105 @@
+#include "motion_config.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+
+#include "params.h"
+
+LOG_MODULE_REGISTER(motion_config, LOG_LEVEL_INF);
+
+#define MOTION_CONFIG_SUBTREE "motion"
+
+static struct motion_config config = {
+	.travel_steps = CONFIG_CHICKEN_COOP_TRAVEL_STEPS,
+	.cruise_speed = CONFIG_CHICKEN_COOP_CRUISE_SPEED,
+	.acceleration = CONFIG_CHICKEN_COOP_ACCELERATION,
+	.hold_timeout = CONFIG_CHICKEN_COOP_HOLD_TIMEOUT,
+};
+
+/* Settings key, storage and valid range of every value. */
+static const struct param_entry entries[MOTION_CONFIG_COUNT] = {
+	[MOTION_CONFIG_TRAVEL_STEPS] = {
+		"travel", &config.travel_steps, PARAM_U16, 1, UINT16_MAX
+	},
+	[MOTION_CONFIG_CRUISE_SPEED] = {
+		"cruise", &config.cruise_speed, PARAM_U16,
+		CONFIG_CHICKEN_COOP_START_SPEED, MOTION_CONFIG_CRUISE_SPEED_MAX
+	},
+	[MOTION_CONFIG_ACCELERATION] = {
+		"accel", &config.acceleration, PARAM_U32, 1, 1000000
+	},
+	[MOTION_CONFIG_HOLD_TIMEOUT] = {
+		"hold", &config.hold_timeout, PARAM_U16, 0, 60000
+	},
+};
+
+PARAM_TABLE_DEFINE(params, MOTION_CONFIG_SUBTREE, entries);
+
+static atomic_t profile_changed;
+
+static bool is_profile(enum motion_config_key key)
+{
+	return key == MOTION_CONFIG_CRUISE_SPEED || key == MOTION_CONFIG_ACCELERATION;
+}
+
+const struct motion_config *motion_config_get(void)
+{
+	return &config;
+}
+
+bool motion_config_valid(enum motion_config_key key, uint32_t value)
+{
+	return value <= INT32_MAX && param_in_range(&params, key, value);
+}
+
+int motion_config_set(enum motion_config_key key, uint32_t value)
+{
+	if (!motion_config_valid(key, value)) {
+		return -EINVAL;
+	}
+
+	param_set(&params, key, value);
+
+	if (is_profile(key)) {
+		atomic_set(&profile_changed, 1);
+	}
+
+	return 0;
+}
+
+bool motion_config_profile_changed(void)
+{
+	return atomic_set(&profile_changed, 0) != 0;
+}
+
+static int motion_config_settings_set(const char *name, size_t len,
+				      settings_read_cb read_cb, void *cb_arg)
+{
+	int key;
+	int32_t value;
+	int rc = param_read(&params, name, len, read_cb, cb_arg, &key, &value);
+
+	if (rc) {
+		return rc;
+	}
+
+	/* Ignore values stored by a firmware with wider limits. */
+	if (!param_in_range(&params, key, value)) {
+		LOG_WRN("Ignoring stored %s: %d", entries[key].name, value);
+		return 0;
+	}
+
+	param_value_set(&params, key, value);
+	if (is_profile(key)) {
+		atomic_set(&profile_changed, 1);
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(motion_config, MOTION_CONFIG_SUBTREE, NULL,
+			       motion_config_settings_set, NULL, NULL);
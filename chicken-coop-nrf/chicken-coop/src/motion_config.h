@@ -0,0 +1,56 @@
+#ifndef MOTION_CONFIG_H
+#define MOTION_CONFIG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Motion parameters that can be tuned at runtime. */
+enum motion_config_key {
+	/* Steps between the closed and the open position. */
+	MOTION_CONFIG_TRAVEL_STEPS,
+	/* Cruise speed [steps/s]. */
+	MOTION_CONFIG_CRUISE_SPEED,
+	/* Acceleration [steps/s^2]. */
+	MOTION_CONFIG_ACCELERATION,
+	/* Time the motor keeps holding the door after a move [ms]. */
+	MOTION_CONFIG_HOLD_TIMEOUT,
+	MOTION_CONFIG_COUNT,
+};
+
+/* Fastest cruise speed accepted [steps/s]. */
+#define MOTION_CONFIG_CRUISE_SPEED_MAX 20000
+
+struct motion_config {
+	uint16_t travel_steps;
+	uint16_t cruise_speed;
+	uint32_t acceleration;
+	uint16_t hold_timeout;
+};
+
+/**@brief Get the configuration.
+ *
+ * Values live in RAM. They are loaded from settings once at boot by
+ * settings_load(), which starts from the Kconfig defaults.
+ */
+const struct motion_config *motion_config_get(void);
+
+/**@brief Change a value and persist it.
+ *
+ * The RAM copy is updated right away, writing to flash is deferred to the
+ * system workqueue.
+ *
+ * @param[in]   key     Value to change.
+ * @param[in]   value   New value.
+ *
+ * @retval 0        Value changed.
+ * @retval -EINVAL  Value out of range.
+ */
+int motion_config_set(enum motion_config_key key, uint32_t value);
+
+/**@brief Check whether a value is in range without changing anything. */
+bool motion_config_valid(enum motion_config_key key, uint32_t value);
+
+/**@brief Whether the speed profile changed since the last call. */
+bool motion_config_profile_changed(void);
+
+#endif
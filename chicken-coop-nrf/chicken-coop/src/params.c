@@ -0,0 +1,126 @@
+#include "params.h"
+
+#include <errno.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(params, LOG_LEVEL_INF);
+
+static size_t param_size(const struct param_entry *entry)
+{
+	switch (entry->type) {
+	case PARAM_BOOL:
+		return sizeof(bool);
+	case PARAM_U16:
+		return sizeof(uint16_t);
+	case PARAM_S16:
+		return sizeof(int16_t);
+	default:
+		return sizeof(uint32_t);
+	}
+}
+
+void param_save_work_handler(struct k_work *work)
+{
+	struct param_table *table = CONTAINER_OF(work, struct param_table, save_work);
+	char key[32];
+
+	for (size_t i = 0; i < table->count; i++) {
+		const struct param_entry *entry = &table->entries[i];
+
+		if (!atomic_test_and_clear_bit(&table->dirty, i)) {
+			continue;
+		}
+
+		snprintk(key, sizeof(key), "%s/%s", table->subtree, entry->name);
+
+		int err = settings_save_one(key, entry->value, param_size(entry));
+
+		if (err) {
+			LOG_ERR("Cannot save %s (err: %d)", key, err);
+		}
+	}
+}
+
+bool param_in_range(const struct param_table *table, int key, int32_t value)
+{
+	return key >= 0 && (size_t)key < table->count &&
+	       value >= table->entries[key].min && value <= table->entries[key].max;
+}
+
+void param_value_set(const struct param_table *table, int key, int32_t value)
+{
+	const struct param_entry *entry = &table->entries[key];
+
+	switch (entry->type) {
+	case PARAM_BOOL:
+		*(bool *)entry->value = value;
+		break;
+	case PARAM_U16:
+		*(uint16_t *)entry->value = value;
+		break;
+	case PARAM_S16:
+		*(int16_t *)entry->value = value;
+		break;
+	default:
+		*(uint32_t *)entry->value = value;
+		break;
+	}
+}
+
+void param_set(struct param_table *table, int key, int32_t value)
+{
+	param_value_set(table, key, value);
+
+	atomic_set_bit(&table->dirty, key);
+	k_work_submit(&table->save_work);
+}
+
+int param_read(const struct param_table *table, const char *name, size_t len,
+	       settings_read_cb read_cb, void *cb_arg, int *key, int32_t *value)
+{
+	const char *next;
+
+	for (size_t i = 0; i < table->count; i++) {
+		const struct param_entry *entry = &table->entries[i];
+
+		if (!settings_name_steq(name, entry->name, &next) || next) {
+			continue;
+		}
+
+		if (len != param_size(entry)) {
+			return -EINVAL;
+		}
+
+		union {
+			bool b;
+			uint16_t u16;
+			int16_t s16;
+			uint32_t u32;
+		} stored;
+		int rc = read_cb(cb_arg, &stored, len);
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		switch (entry->type) {
+		case PARAM_BOOL:
+			*value = stored.b;
+			break;
+		case PARAM_U16:
+			*value = stored.u16;
+			break;
+		case PARAM_S16:
+			*value = stored.s16;
+			break;
+		default:
+			*value = stored.u32;
+			break;
+		}
+		*key = i;
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
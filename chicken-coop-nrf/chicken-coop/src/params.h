@@ -0,0 +1,86 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+/* Runtime parameters of a module, kept in RAM and persisted one settings
+ * key per value under the subtree of the module. The module owns the values
+ * and the table of entries, indexed by its own key enum, and registers its
+ * own settings handler around param_read().
+ */
+
+/* Storage of a value, also its size in settings. */
+enum param_type {
+	PARAM_BOOL,
+	PARAM_U16,
+	PARAM_S16,
+	PARAM_U32,
+};
+
+/* Settings key, storage and valid range of a value. */
+struct param_entry {
+	const char *name;
+	void *value;
+	enum param_type type;
+	int32_t min;
+	int32_t max;
+};
+
+struct param_table {
+	const char *subtree;
+	const struct param_entry *entries;
+	size_t count;
+	/* Keys changed since the last save. */
+	atomic_t dirty;
+	struct k_work save_work;
+};
+
+void param_save_work_handler(struct k_work *work);
+
+/**@brief Define the table of a module over its array of entries. */
+#define PARAM_TABLE_DEFINE(_name, _subtree, _entries)				   \
+	BUILD_ASSERT(ARRAY_SIZE(_entries) <= ATOMIC_BITS);			   \
+	static struct param_table _name = {					   \
+		.subtree = _subtree,						   \
+		.entries = _entries,						   \
+		.count = ARRAY_SIZE(_entries),					   \
+		.save_work = Z_WORK_INITIALIZER(param_save_work_handler),	   \
+	}
+
+/**@brief Check a value against the range of its entry. */
+bool param_in_range(const struct param_table *table, int key, int32_t value);
+
+/**@brief Change a value in RAM only. */
+void param_value_set(const struct param_table *table, int key, int32_t value);
+
+/**@brief Change a value and persist it.
+ *
+ * The RAM copy is updated right away, writing to flash is deferred to the
+ * system workqueue. The range is up to the caller.
+ */
+void param_set(struct param_table *table, int key, int32_t value);
+
+/**@brief Read a stored value for a settings handler, without applying it.
+ *
+ * @param[in]   table     Table of the module.
+ * @param[in]   name      Key relative to the subtree.
+ * @param[in]   len       Length of the stored value.
+ * @param[in]   read_cb   Read callback of the settings handler.
+ * @param[in]   cb_arg    Argument of the read callback.
+ * @param[out]  key       Key of the entry.
+ * @param[out]  value     Stored value.
+ *
+ * @retval 0        Value read.
+ * @retval -ENOENT  Unknown key.
+ * @retval -EINVAL  Stored with another size.
+ */
+int param_read(const struct param_table *table, const char *name, size_t len,
+	       settings_read_cb read_cb, void *cb_arg, int *key, int32_t *value);
+
+#endif
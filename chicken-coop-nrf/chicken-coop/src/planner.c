@@ -0,0 +1,144 @@
+#include "planner.h"
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(planner, LOG_LEVEL_INF);
+
+#define US_PER_S 1000000
+
+/* Integration step used while building the ramp. */
+#define RAMP_TICK_US 16
+
+/* Step intervals of the acceleration ramp [us]. Deceleration plays it backwards. */
+static uint16_t ramp[CONFIG_CHICKEN_COOP_RAMP_MAX_STEPS];
+static uint32_t ramp_len;
+static uint32_t cruise_interval;
+static uint32_t start_interval;
+
+int planner_configure(uint32_t start_speed, uint32_t cruise_speed, uint32_t accel, uint32_t jerk)
+{
+	/* Velocity and acceleration are Q16 steps/s and steps/s^2. Position is
+	 * kept multiplied by 1e6 so that advancing it by v * dt needs no division.
+	 */
+	const int64_t v_max = (int64_t)cruise_speed << 16;
+	const int64_t a_max = (int64_t)accel << 16;
+	const int64_t j_tick = ((int64_t)jerk << 16) * RAMP_TICK_US / US_PER_S;
+	const int64_t step_pos = ((int64_t)1 << 16) * US_PER_S;
+	int64_t v = (int64_t)start_speed << 16;
+	int64_t a = jerk ? 0 : a_max;
+	int64_t pos = 0;
+	int64_t next_step = step_pos;
+	uint32_t t = 0;
+	uint32_t t_last = 0;
+	uint32_t n = 0;
+
+	if (start_speed == 0 || cruise_speed == 0 || accel == 0 ||
+	    US_PER_S / start_speed > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	while (n < ARRAY_SIZE(ramp) && v < v_max) {
+		if (jerk) {
+			int64_t a_q8 = a >> 8;
+
+			/* Start easing off early enough to reach cruise speed with zero acceleration. */
+			if (v_max - v <= a_q8 * a_q8 / (2 * (int64_t)jerk)) {
+				a -= j_tick;
+				if (a <= 0) {
+					break;
+				}
+			} else {
+				a = MIN(a + j_tick, a_max);
+			}
+		}
+
+		int64_t prev = pos;
+
+		v = MIN(v + a * RAMP_TICK_US / US_PER_S, v_max);
+		pos += v * RAMP_TICK_US;
+
+		if (pos >= next_step) {
+			/* Interpolate when inside this tick the step boundary was crossed. */
+			uint32_t t_step = t + (uint32_t)((next_step - prev) * RAMP_TICK_US / (pos - prev));
+
+			ramp[n++] = t_step - t_last;
+			t_last = t_step;
+			next_step += step_pos;
+		}
+
+		t += RAMP_TICK_US;
+	}
+
+	ramp_len = n;
+	start_interval = US_PER_S / start_speed;
+
+	if (n == ARRAY_SIZE(ramp)) {
+		/* Ran out of table before reaching cruise speed, stay at the last speed. */
+		cruise_interval = ramp[n - 1];
+		LOG_WRN("Ramp truncated, cruising at %u us per step", cruise_interval);
+	} else {
+		cruise_interval = US_PER_S / MAX(cruise_speed, start_speed);
+	}
+
+	LOG_INF("Ramp of %u steps, cruise interval %u us", ramp_len, cruise_interval);
+
+	return 0;
+}
+
+int planner_init(void)
+{
+	return planner_configure(CONFIG_CHICKEN_COOP_START_SPEED,
+				 CONFIG_CHICKEN_COOP_CRUISE_SPEED,
+				 CONFIG_CHICKEN_COOP_ACCELERATION,
+				 CONFIG_CHICKEN_COOP_JERK);
+}
+
+void planner_plan(struct planner_move *move, uint32_t steps)
+{
+	/* A move of n steps has n - 1 intervals, shared by both ramps and cruise. */
+	move->steps = steps;
+	move->ramp_steps = steps ? MIN(ramp_len, (steps - 1) / 2) : 0;
+	move->cruise_interval = cruise_interval;
+}
+
+void planner_plan_slow(struct planner_move *move, uint32_t steps)
+{
+	move->steps = steps;
+	move->ramp_steps = 0;
+	move->cruise_interval = start_interval;
+}
+
+bool planner_decelerate(struct planner_move *move, uint32_t step)
+{
+	/* Up to step, the door went through at most this much of the ramp. */
+	uint32_t ramp_down = MIN(step, move->ramp_steps);
+	uint32_t steps = step + ramp_down + 1;
+
+	if (steps >= move->steps) {
+		return false;
+	}
+
+	/* Steps before the new ramp are past the acceleration ramp of the
+	 * shortened move, or still on it with the same intervals.
+	 */
+	move->steps = steps;
+	move->ramp_steps = ramp_down;
+
+	return true;
+}
+
+uint32_t planner_interval(const struct planner_move *move, uint32_t step)
+{
+	if (step < move->ramp_steps) {
+		return ramp[step];
+	}
+
+	if (step + 1 < move->steps && step + 1 + move->ramp_steps >= move->steps) {
+		return ramp[move->steps - 2 - step];
+	}
+
+	return move->cruise_interval;
+}
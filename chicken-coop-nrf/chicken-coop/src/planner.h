@@ -0,0 +1,70 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Step timing of a single move. */
+struct planner_move {
+	/* Total number of steps. */
+	uint32_t steps;
+	/* Number of intervals spent on each of the acceleration and deceleration ramps. */
+	uint32_t ramp_steps;
+	/* Interval between steps outside of the ramps [us]. */
+	uint32_t cruise_interval;
+};
+
+/**@brief Precompute the acceleration ramp.
+ *
+ * Builds the table of step intervals used by every move. This is the only
+ * place doing any real math, the step interrupt only looks values up.
+ *
+ * @param[in]   start_speed    Speed at the start and end of a move [steps/s].
+ * @param[in]   cruise_speed   Maximum speed [steps/s].
+ * @param[in]   accel          Maximum acceleration [steps/s^2].
+ * @param[in]   jerk           Jerk [steps/s^3], 0 for a trapezoidal ramp.
+ *
+ * @retval 0        Ramp computed.
+ * @retval -EINVAL  Invalid parameters.
+ */
+int planner_configure(uint32_t start_speed, uint32_t cruise_speed, uint32_t accel, uint32_t jerk);
+
+/**@brief Precompute the acceleration ramp from the Kconfig defaults. */
+int planner_init(void);
+
+/**@brief Split a move into acceleration, cruise and deceleration.
+ *
+ * @param[out]  move    Move to fill in.
+ * @param[in]   steps   Number of steps of the move.
+ */
+void planner_plan(struct planner_move *move, uint32_t steps);
+
+/**@brief Plan a move running at start speed all along, e.g. to look for an endstop.
+ *
+ * @param[out]  move    Move to fill in.
+ * @param[in]   steps   Number of steps of the move.
+ */
+void planner_plan_slow(struct planner_move *move, uint32_t steps);
+
+/**@brief Cut a move short with a deceleration starting at a given step.
+ *
+ * The deceleration mirrors the part of the acceleration ramp played so far,
+ * so the speed never jumps. Intervals before the step are unchanged.
+ *
+ * @param[in,out]  move   Move in progress.
+ * @param[in]      step   First step whose interval may change.
+ *
+ * @return True if the move got shorter, false if it already stops as early.
+ */
+bool planner_decelerate(struct planner_move *move, uint32_t step);
+
+/**@brief Get the interval following a step.
+ *
+ * @param[in]   move   Planned move.
+ * @param[in]   step   Index of the step, counted from 0.
+ *
+ * @return Time between this step and the next one [us].
+ */
+uint32_t planner_interval(const struct planner_move *move, uint32_t step);
+
+#endif
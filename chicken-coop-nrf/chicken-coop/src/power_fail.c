@@ -0,0 +1,152 @@
+#include "power_fail.h"
+#include "stepper.h"
+
+#include <errno.h>
+#include <nrfx_nvmc.h>
+#include <nrfx_power.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
+
+LOG_MODULE_REGISTER(power_fail, LOG_LEVEL_INF);
+
+/* Must leave enough time for the stop and three word writes, 41 us each. */
+#define power_fail_threshold NRF_POWER_POFTHR_V28
+
+#define POWER_FAIL_MAGIC 0xD0035AFEU
+#define POWER_FAIL_PAGE_SIZE 4096
+
+struct power_fail_record {
+	/* Written last, a record cut short by the brownout stays invalid.
+	 * Cleared to 0 once the record was restored.
+	 */
+	uint32_t magic;
+	int32_t position;
+	uint32_t crc;
+};
+
+#define POWER_FAIL_SLOTS (POWER_FAIL_PAGE_SIZE / sizeof(struct power_fail_record))
+
+/* One flash page of the application image, programmed erased. Only
+ * written 1 to 0 by the interrupt, erased at boot once full. There is no
+ * bootloader checking the image, so changing it is fine.
+ *
+ * The NVMC changes it behind the compiler's back, the compiler would fold
+ * plain reads into the erased initializer. It is only read through volatile
+ * pointers. Declaring the array volatile itself would move it to RAM.
+ */
+static const struct power_fail_record records[POWER_FAIL_SLOTS]
+	__aligned(POWER_FAIL_PAGE_SIZE) = {
+	[0 ... POWER_FAIL_SLOTS - 1] = { UINT32_MAX, -1, UINT32_MAX },
+};
+
+/* Slot written by the next power failure, NULL once written. */
+static const volatile struct power_fail_record *volatile next_slot;
+
+/* Record written by a brownout the device survived. */
+static const volatile struct power_fail_record *volatile written_slot;
+
+static uint32_t record_crc(int32_t position)
+{
+	return crc32_ieee((const uint8_t *)&position, sizeof(position));
+}
+
+static bool record_free(const volatile struct power_fail_record *record)
+{
+	const volatile uint32_t *word = (const volatile uint32_t *)record;
+
+	for (size_t i = 0; i < sizeof(*record) / sizeof(uint32_t); i++) {
+		if (word[i] != UINT32_MAX) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void word_write(const volatile void *addr, uint32_t value)
+{
+	nrfx_nvmc_word_write((uint32_t)addr, value);
+}
+
+static void pofwarn_handler(void)
+{
+	const volatile struct power_fail_record *slot = next_slot;
+	int32_t position;
+
+	/* The comparator keeps firing while the supply hovers around the threshold. */
+	if (!slot) {
+		return;
+	}
+	next_slot = NULL;
+
+	/* Also takes the motor load off the failing supply. */
+	if (!stepper_emergency_stop(&position)) {
+		return;
+	}
+
+	word_write(&slot->position, position);
+	word_write(&slot->crc, record_crc(position));
+	word_write(&slot->magic, POWER_FAIL_MAGIC);
+	written_slot = slot;
+}
+
+void power_fail_rearm(void)
+{
+	const volatile struct power_fail_record *slot = written_slot;
+
+	if (!slot) {
+		return;
+	}
+	written_slot = NULL;
+
+	LOG_WRN("Supply recovered after a power fail warning");
+
+	/* The door is about to move, the record would be stale. Without a free
+	 * slot left, the next one is only available after the next boot.
+	 */
+	word_write(&slot->magic, 0);
+	next_slot = slot + 1 < &records[POWER_FAIL_SLOTS] ? slot + 1 : NULL;
+}
+
+int power_fail_init(int32_t *position)
+{
+	nrfx_power_pofwarn_config_t config = {
+		.handler = pofwarn_handler,
+		.thr = power_fail_threshold,
+	};
+	const volatile struct power_fail_record *saved = NULL;
+	size_t used = 0;
+
+	for (size_t i = 0; i < POWER_FAIL_SLOTS; i++) {
+		const volatile struct power_fail_record *record = &records[i];
+
+		if (record_free(record)) {
+			continue;
+		}
+		used = i + 1;
+
+		if (record->magic == POWER_FAIL_MAGIC &&
+		    record->crc == record_crc(record->position)) {
+			saved = record;
+		}
+	}
+
+	if (saved) {
+		*position = saved->position;
+		word_write(&saved->magic, 0);
+		LOG_INF("Position %d restored after power failure", *position);
+	}
+
+	/* Erasing stalls the CPU for about 85 ms, still fine before anything moves. */
+	if (used == POWER_FAIL_SLOTS) {
+		nrfx_nvmc_page_erase((uint32_t)records);
+		used = 0;
+	}
+	next_slot = &records[used];
+
+	nrfx_power_pof_init(&config);
+	nrfx_power_pof_enable(&config);
+
+	return saved ? 0 : -ENOENT;
+}
@@ -0,0 +1,38 @@
+#ifndef POWER_FAIL_H
+#define POWER_FAIL_H
+
+#include <stdint.h>
+
+/* Door position kept across power failures. The power fail comparator warns
+ * while the supply is still falling, the motor is stopped and the position
+ * written into a pre-erased flash record in well under a millisecond.
+ * Without CONFIG_CHICKEN_COOP_POWER_FAIL these calls do nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_POWER_FAIL
+
+/**@brief Take the position saved at the last power failure and arm the comparator.
+ *
+ * Called once by the motion thread before anything moves. The record is
+ * consumed, a later reset without a power failure does not restore it again.
+ *
+ * @param[out]  position   Saved absolute position in steps.
+ *
+ * @retval 0        Position restored.
+ * @retval -ENOENT  Nothing saved.
+ */
+int power_fail_init(int32_t *position);
+
+/**@brief Drop the record of a brownout the device survived, before the next move. */
+void power_fail_rearm(void);
+
+#else
+
+#include <errno.h>
+
+static inline int power_fail_init(int32_t *position) { return -ENOENT; }
+static inline void power_fail_rearm(void) {}
+
+#endif
+
+#endif
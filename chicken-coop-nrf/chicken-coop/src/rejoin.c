@@ -0,0 +1,107 @@
+#include "rejoin.h"
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+LOG_MODULE_REGISTER(rejoin, LOG_LEVEL_INF);
+
+#define REJOIN_SUBTREE "net"
+
+/* Last network joined, as stored. Channel 0 if none. */
+struct rejoin_network {
+	zb_uint8_t channel;
+	zb_ext_pan_id_t ext_pan_id;
+};
+
+static struct rejoin_network last;
+
+static const zb_ext_pan_id_t any_pan;
+
+/* Whether steering is still restricted to the last PAN, Zigbee thread only. */
+static bool restricted;
+
+static void save_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	int err = settings_save_one(REJOIN_SUBTREE "/last", &last, sizeof(last));
+
+	if (err) {
+		LOG_ERR("Cannot save network (err: %d)", err);
+	}
+}
+
+static K_WORK_DEFINE(save_work, save_work_handler);
+
+void rejoin_prepare(void)
+{
+	if (last.channel < 11 || last.channel > 26 ||
+	    !(BIT(last.channel) & CONFIG_ZIGBEE_CHANNEL_MASK) ||
+	    !memcmp(last.ext_pan_id, any_pan, sizeof(any_pan))) {
+		return;
+	}
+
+	/* Steering goes through the primary channels first and the
+	 * secondary ones only if it found nothing to join there.
+	 */
+	zb_set_bdb_primary_channel_set(BIT(last.channel));
+	zb_set_bdb_secondary_channel_set(CONFIG_ZIGBEE_CHANNEL_MASK);
+	zb_set_extended_pan_id(last.ext_pan_id);
+	restricted = true;
+
+	LOG_INF("Trying channel %u first", last.channel);
+}
+
+void rejoin_network_joined(void)
+{
+	struct rejoin_network now = {
+		.channel = zb_get_current_channel(),
+	};
+
+	zb_get_extended_pan_id(now.ext_pan_id);
+
+	if (!memcmp(&now, &last, sizeof(now))) {
+		return;
+	}
+
+	last = now;
+	k_work_submit(&save_work);
+}
+
+void rejoin_steering_failed(void)
+{
+	if (!restricted) {
+		return;
+	}
+
+	/* The network is gone or moved, the retry scans everything. */
+	zb_set_extended_pan_id(any_pan);
+	zb_set_bdb_primary_channel_set(CONFIG_ZIGBEE_CHANNEL_MASK);
+	zb_set_bdb_secondary_channel_set(0);
+	restricted = false;
+
+	LOG_WRN("Last network not found, scanning all channels");
+}
+
+static int rejoin_settings_set(const char *name, size_t len,
+			       settings_read_cb read_cb, void *cb_arg)
+{
+	const char *next;
+
+	if (!settings_name_steq(name, "last", &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len != sizeof(last)) {
+		return -EINVAL;
+	}
+
+	int rc = read_cb(cb_arg, &last, len);
+
+	return rc < 0 ? rc : 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(rejoin, REJOIN_SUBTREE, NULL,
+			       rejoin_settings_set, NULL, NULL);
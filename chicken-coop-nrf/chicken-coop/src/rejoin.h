@@ -0,0 +1,35 @@
+#ifndef REJOIN_H
+#define REJOIN_H
+
+/* Fast rejoin. The channel and extended PAN ID of the last network joined
+ * are kept in settings. When the stack has no network in its NVRAM, network
+ * steering scans that channel for that PAN first, and all channels of
+ * CONFIG_ZIGBEE_CHANNEL_MASK for any PAN only when that fails. A device with
+ * a network in its NVRAM rejoins on the stored channel by itself. Without
+ * CONFIG_CHICKEN_COOP_FAST_REJOIN these calls do nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_FAST_REJOIN
+
+#include <zboss_api.h>
+
+/**@brief Narrow the first scan to the last network, after settings_load()
+ *        and before zigbee_enable().
+ */
+void rejoin_prepare(void);
+
+/**@brief Remember the network once joined, from the Zigbee thread. */
+void rejoin_network_joined(void);
+
+/**@brief Accept any PAN on the next steering attempt, from the Zigbee thread. */
+void rejoin_steering_failed(void);
+
+#else
+
+static inline void rejoin_prepare(void) {}
+static inline void rejoin_network_joined(void) {}
+static inline void rejoin_steering_failed(void) {}
+
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+#include "retained.h"
+
+#include <stddef.h>
+#include <string.h>
+#ifdef CONFIG_SOC_FAMILY_NRF
+#include <hal/nrf_power.h>
+#endif
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
+
+#define RETAINED_MAGIC 0xC00BB007U
+
+struct retained {
+	uint32_t magic;
+	struct retained_door door;
+	struct retained_zcl zcl;
+	/* Over everything above. */
+	uint32_t crc;
+};
+
+static __noinit struct retained retained;
+
+/* Copy taken at boot, valid only after a warm reset. */
+static struct retained restored;
+static bool warm;
+
+static uint32_t retained_crc(const struct retained *r)
+{
+	return crc32_ieee((const uint8_t *)r, offsetof(struct retained, crc));
+}
+
+static int retained_init(void)
+{
+#ifdef CONFIG_SOC_FAMILY_NRF
+	/* Power-on and brownout resets clear the reset reason, and RAM with
+	 * it. Left as is for the Zigbee stack to report.
+	 */
+	warm = nrf_power_resetreas_get(NRF_POWER) && retained.magic == RETAINED_MAGIC &&
+	       retained.crc == retained_crc(&retained);
+#endif
+	if (warm) {
+		restored = retained;
+		return 0;
+	}
+
+	memset(&retained, 0, sizeof(retained));
+	retained.magic = RETAINED_MAGIC;
+	retained.crc = retained_crc(&retained);
+
+	return 0;
+}
+
+SYS_INIT(retained_init, PRE_KERNEL_1, 0);
+
+const struct retained_door *retained_door_get(void)
+{
+	return warm ? &restored.door : NULL;
+}
+
+const struct retained_zcl *retained_zcl_get(void)
+{
+	return warm ? &restored.zcl : NULL;
+}
+
+void retained_door_set(int32_t position, bool position_known)
+{
+	unsigned int key = irq_lock();
+
+	retained.door.position = position;
+	retained.door.position_known = position_known;
+	retained.crc = retained_crc(&retained);
+
+	irq_unlock(key);
+}
+
+void retained_zcl_set(const struct retained_zcl *zcl)
+{
+	unsigned int key = irq_lock();
+
+	retained.zcl = *zcl;
+	retained.crc = retained_crc(&retained);
+
+	irq_unlock(key);
+}
@@ -0,0 +1,41 @@
+#ifndef RETAINED_H
+#define RETAINED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* State kept in RAM that is not initialized at boot. RAM survives watchdog,
+ * soft and pin resets, so a warm restart picks up the door and the ZCL
+ * attributes where they were, without flash reads and without homing. The
+ * block is protected by a CRC and ignored after a power-on reset.
+ */
+
+struct retained_door {
+	/* Absolute position in steps. */
+	int32_t position;
+	/* False while the door moves, it is unknown after a reset mid-move. */
+	bool position_known;
+};
+
+/* Last values of the attributes driven by the door and the sensors. */
+struct retained_zcl {
+	uint8_t on_off;
+	uint8_t lift_percent;
+	uint8_t door_state;
+	uint16_t illuminance;
+	int16_t position_error;
+};
+
+/**@brief Door state from before the reset, NULL after a cold boot. */
+const struct retained_door *retained_door_get(void);
+
+/**@brief Attribute values from before the reset, NULL after a cold boot. */
+const struct retained_zcl *retained_zcl_get(void);
+
+/**@brief Keep the door state for the next warm reset. Safe from any thread. */
+void retained_door_set(int32_t position, bool position_known);
+
+/**@brief Keep the attribute values for the next warm reset. Safe from any thread. */
+void retained_zcl_set(const struct retained_zcl *zcl);
+
+#endif
@@ -0,0 +1,284 @@
+#include "motion.h"
+#include "zcl_shim.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+#include <zboss_api.h>
+#include <zigbee/zigbee_app_utils.h>
+
+/* Routing health while the door moves. Frames are forwarded by the Zigbee
+ * thread, so a probe callback is queued to it every
+ * CONFIG_CHICKEN_COOP_ROUTE_BENCH_PERIOD ms, first with the door idle, then
+ * while it opens and closes. The time a probe waits for the thread is the
+ * time a frame to forward would wait. The buffer pool is sampled with every
+ * probe. Meanwhile the benchmark reads an attribute of a remote node every
+ * CONFIG_CHICKEN_COOP_ROUTE_BENCH_TRAFFIC_PERIOD ms, so both phases carry the
+ * same stream of APS acknowledged frames, and counts their confirms.
+ */
+
+/* Probe delays by powers of two in us, the last bin takes everything longer. */
+#define ROUTE_BENCH_BINS 20
+
+/* Probe periods between two reads of the remote node. */
+#define ROUTE_BENCH_TRAFFIC_TICKS MAX(1, CONFIG_CHICKEN_COOP_ROUTE_BENCH_TRAFFIC_PERIOD / \
+				      CONFIG_CHICKEN_COOP_ROUTE_BENCH_PERIOD)
+
+enum route_bench_phase {
+	ROUTE_BENCH_IDLE,
+	ROUTE_BENCH_MOVING,
+	ROUTE_BENCH_DONE,
+};
+
+struct route_bench_stats {
+	uint32_t probes;
+	/* Not queued, the callback queue of the Zigbee thread was full. */
+	uint32_t dropped;
+	/* Waited longer than CONFIG_CHICKEN_COOP_ROUTE_BENCH_DELAYED. */
+	uint32_t delayed;
+	/* Not sent, the previous probe was still waiting. */
+	uint32_t overrun;
+	uint32_t max_us;
+	/* Probes that saw the buffer pool low, or out of buffers. */
+	uint32_t buf_low;
+	uint32_t buf_oom;
+	uint32_t hist[ROUTE_BENCH_BINS];
+	/* Reads of the remote node, acknowledged or not, including those
+	 * without a buffer or a slot in the callback queue.
+	 */
+	uint32_t sent;
+	uint32_t acked;
+	uint32_t failed;
+	/* Not sent, the previous read still waited for its confirm. */
+	uint32_t busy;
+	/* From the read to its APS confirm, over the acknowledged reads. */
+	uint64_t ack_sum_us;
+	uint32_t ack_max_us;
+};
+
+static struct route_bench_stats stats[ROUTE_BENCH_DONE];
+static atomic_t phase = ATOMIC_INIT(ROUTE_BENCH_DONE);
+static atomic_t pending;
+static int64_t probe_sent;
+static uint32_t ticks_left;
+
+/* Read in flight, one at a time. */
+static atomic_t read_pending;
+static int64_t read_sent;
+static enum route_bench_phase read_phase;
+static uint32_t read_ticks;
+
+/* Door cycling, only touched by the work handler. */
+static uint32_t moves_left;
+static enum door_state target;
+
+static void probe_timer_expiry(struct k_timer *timer);
+static K_TIMER_DEFINE(probe_timer, probe_timer_expiry, NULL);
+
+static void probe(zb_uint8_t param)
+{
+	struct route_bench_stats *s = &stats[param];
+	uint32_t delay = k_ticks_to_us_floor32(k_uptime_ticks() - probe_sent);
+	int bin = delay ? 32 - __builtin_clz(delay) : 0;
+
+	s->probes++;
+	s->max_us = MAX(s->max_us, delay);
+	s->hist[MIN(bin, ROUTE_BENCH_BINS - 1)]++;
+	if (delay > CONFIG_CHICKEN_COOP_ROUTE_BENCH_DELAYED * USEC_PER_MSEC) {
+		s->delayed++;
+	}
+	if (zb_buf_memory_low()) {
+		s->buf_low++;
+	}
+	if (zb_buf_is_oom_state()) {
+		s->buf_oom++;
+	}
+
+	atomic_clear(&pending);
+}
+
+/**@brief APS confirm of a read, or its failure.
+ *
+ * @param[in]   bufid   Buffer holding the send status.
+ */
+static void read_confirm(zb_bufid_t bufid)
+{
+	zb_zcl_command_send_status_t *send_status =
+		ZB_BUF_GET_PARAM(bufid, zb_zcl_command_send_status_t);
+	struct route_bench_stats *s = &stats[read_phase];
+	uint32_t latency = k_ticks_to_us_floor32(k_uptime_ticks() - read_sent);
+
+	if (send_status->status == RET_OK) {
+		s->acked++;
+		s->ack_sum_us += latency;
+		s->ack_max_us = MAX(s->ack_max_us, latency);
+	} else {
+		s->failed++;
+	}
+
+	zb_buf_free(bufid);
+	atomic_clear(&read_pending);
+}
+
+/**@brief Read the ZCL version of the remote node, a unicast with APS acknowledgement.
+ *
+ * @param[in]   bufid   Buffer to send the request with.
+ * @param[in]   param   Phase the read belongs to.
+ */
+static void read_request(zb_bufid_t bufid, zb_uint16_t param)
+{
+	zb_uint8_t *cmd_ptr;
+	zb_uint16_t addr = CONFIG_CHICKEN_COOP_ROUTE_BENCH_REMOTE_ADDR;
+
+	read_phase = param;
+	read_sent = k_uptime_ticks();
+
+	ZB_ZCL_GENERAL_INIT_READ_ATTR_REQ(bufid, cmd_ptr, ZB_ZCL_DISABLE_DEFAULT_RESPONSE);
+	ZB_ZCL_GENERAL_ADD_ID_READ_ATTR_REQ(cmd_ptr, ZB_ZCL_ATTR_BASIC_ZCL_VERSION_ID);
+	ZB_ZCL_GENERAL_SEND_READ_ATTR_REQ(bufid, cmd_ptr, addr,
+					  ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+					  CONFIG_CHICKEN_COOP_ROUTE_BENCH_REMOTE_ENDPOINT,
+					  CHICKEN_COOP_ENDPOINT, ZB_AF_HA_PROFILE_ID,
+					  ZB_ZCL_CLUSTER_ID_BASIC, read_confirm);
+}
+
+static void read_send(zb_uint8_t param)
+{
+	if (zb_buf_get_out_delayed_ext(read_request, param, 0) != RET_OK) {
+		stats[param].failed++;
+		atomic_clear(&read_pending);
+	}
+}
+
+static void stats_print(const char *name, const struct route_bench_stats *s)
+{
+	printk("\"%s\":{\"probes\":%u,\"dropped\":%u,\"delayed\":%u,\"overrun\":%u,"
+	       "\"max_us\":%u,\"buf_low\":%u,\"buf_oom\":%u,\"hist_log2_us\":[",
+	       name, s->probes, s->dropped, s->delayed, s->overrun, s->max_us,
+	       s->buf_low, s->buf_oom);
+	for (int i = 0; i < ROUTE_BENCH_BINS; i++) {
+		printk("%s%u", i ? "," : "", s->hist[i]);
+	}
+	printk("],\"reads\":{\"sent\":%u,\"acked\":%u,\"failed\":%u,\"busy\":%u,"
+	       "\"ack_mean_us\":%u,\"ack_max_us\":%u}}",
+	       s->sent, s->acked, s->failed, s->busy,
+	       s->acked ? (uint32_t)(s->ack_sum_us / s->acked) : 0, s->ack_max_us);
+}
+
+static void report(void)
+{
+	/* One line of JSON, to be diffed between releases. */
+	printk("ROUTE_BENCH {");
+	stats_print("idle", &stats[ROUTE_BENCH_IDLE]);
+	printk(",");
+	stats_print("moving", &stats[ROUTE_BENCH_MOVING]);
+	printk("}\n");
+}
+
+static void door_next(void)
+{
+	target = (motion_state_get() == DOOR_STATE_OPEN) ? DOOR_STATE_CLOSED : DOOR_STATE_OPEN;
+	motion_submit(target == DOOR_STATE_OPEN ? MOTION_CMD_OPEN : MOTION_CMD_CLOSE, 0);
+}
+
+static void probe_work_handler(struct k_work *work)
+{
+	enum route_bench_phase now = atomic_get(&phase);
+
+	ARG_UNUSED(work);
+
+	if (now == ROUTE_BENCH_DONE) {
+		return;
+	}
+
+	if (!atomic_cas(&pending, 0, 1)) {
+		stats[now].overrun++;
+	} else {
+		probe_sent = k_uptime_ticks();
+		if (zigbee_schedule_callback(probe, now)) {
+			stats[now].dropped++;
+			atomic_clear(&pending);
+		}
+	}
+
+	if (++read_ticks >= ROUTE_BENCH_TRAFFIC_TICKS) {
+		read_ticks = 0;
+		if (!atomic_cas(&read_pending, 0, 1)) {
+			stats[now].busy++;
+		} else {
+			stats[now].sent++;
+			if (zigbee_schedule_callback(read_send, now)) {
+				stats[now].failed++;
+				atomic_clear(&read_pending);
+			}
+		}
+	}
+
+	if (now == ROUTE_BENCH_IDLE) {
+		if (--ticks_left == 0) {
+			atomic_set(&phase, ROUTE_BENCH_MOVING);
+			door_next();
+		}
+		return;
+	}
+
+	enum door_state state = motion_state_get();
+
+	if (state == DOOR_STATE_FAULT || state == target) {
+		if (state == DOOR_STATE_FAULT || --moves_left == 0) {
+			k_timer_stop(&probe_timer);
+			atomic_set(&phase, ROUTE_BENCH_DONE);
+			report();
+			return;
+		}
+		door_next();
+	}
+}
+
+static K_WORK_DEFINE(probe_work, probe_work_handler);
+
+static void probe_timer_expiry(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	k_work_submit(&probe_work);
+}
+
+static int cmd_route_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t cycles = (argc > 1) ? strtoul(argv[1], NULL, 0) : 5;
+
+	if (atomic_get(&phase) != ROUTE_BENCH_DONE) {
+		shell_error(sh, "Benchmark already running");
+		return -EBUSY;
+	}
+
+	if (!ZB_JOINED() || cycles == 0) {
+		shell_error(sh, "Needs a network and at least one cycle");
+		return -EINVAL;
+	}
+
+	memset(stats, 0, sizeof(stats));
+	atomic_clear(&pending);
+	read_ticks = 0;
+	ticks_left = CONFIG_CHICKEN_COOP_ROUTE_BENCH_IDLE * MSEC_PER_SEC /
+		     CONFIG_CHICKEN_COOP_ROUTE_BENCH_PERIOD;
+	moves_left = 2 * cycles;
+	atomic_set(&phase, ROUTE_BENCH_IDLE);
+
+	k_timer_start(&probe_timer, K_MSEC(CONFIG_CHICKEN_COOP_ROUTE_BENCH_PERIOD),
+		      K_MSEC(CONFIG_CHICKEN_COOP_ROUTE_BENCH_PERIOD));
+
+	shell_print(sh, "Idle for %u s, then %u open and close cycles, reading 0x%04x",
+		    CONFIG_CHICKEN_COOP_ROUTE_BENCH_IDLE, cycles,
+		    CONFIG_CHICKEN_COOP_ROUTE_BENCH_REMOTE_ADDR);
+
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((coop), route_bench, NULL,
+		 "Zigbee thread latency, idle then moving the door [cycles]",
+		 cmd_route_bench, 1, 1);
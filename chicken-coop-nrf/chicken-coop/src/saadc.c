@@ -0,0 +1,67 @@
+#include "saadc.h"
+
+#include <soc.h>
+#include <hal/nrf_saadc.h>
+#include <zephyr/init.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+
+/* Above the LEDs, the current sensing has to stop a stalled motor quickly. */
+#define saadc_irq_priority 3
+
+static saadc_end_cb_t end_cb;
+
+static void saadc_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (!nrf_saadc_event_check(NRF_SAADC, NRF_SAADC_EVENT_END)) {
+		return;
+	}
+	nrf_saadc_event_clear(NRF_SAADC, NRF_SAADC_EVENT_END);
+
+	if (end_cb) {
+		end_cb();
+	}
+}
+
+bool saadc_claim(saadc_end_cb_t cb)
+{
+	unsigned int key = irq_lock();
+	bool claimed = !end_cb;
+
+	if (claimed) {
+		end_cb = cb;
+	}
+	irq_unlock(key);
+
+	return claimed;
+}
+
+void saadc_release(void)
+{
+	unsigned int key = irq_lock();
+
+	nrf_saadc_task_trigger(NRF_SAADC, NRF_SAADC_TASK_STOP);
+	while (!nrf_saadc_event_check(NRF_SAADC, NRF_SAADC_EVENT_STOPPED)) {
+	}
+	nrf_saadc_event_clear(NRF_SAADC, NRF_SAADC_EVENT_STOPPED);
+	nrf_saadc_event_clear(NRF_SAADC, NRF_SAADC_EVENT_END);
+
+	nrf_saadc_disable(NRF_SAADC);
+	end_cb = NULL;
+
+	irq_unlock(key);
+}
+
+static int saadc_init(void)
+{
+	nrf_saadc_int_set(NRF_SAADC, NRF_SAADC_INT_END);
+
+	IRQ_CONNECT(SAADC_IRQn, saadc_irq_priority, saadc_isr, NULL, 0);
+	irq_enable(SAADC_IRQn);
+
+	return 0;
+}
+
+SYS_INIT(saadc_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,25 @@
+#ifndef SAADC_H
+#define SAADC_H
+
+#include <stdbool.h>
+
+/* The single SAADC is shared by the light sensor and the motor current
+ * sensing, one at a time. The owner sets up channel 0, the buffer and the
+ * sampling itself, and gets the END events.
+ */
+
+/**@brief Callback for the END event of the owner, from interrupt context. */
+typedef void (*saadc_end_cb_t)(void);
+
+/**@brief Take the SAADC unless somebody else owns it. Safe from any context.
+ *
+ * @param[in]   end_cb   Called on every END event until released.
+ *
+ * @return true if the caller owns the SAADC now.
+ */
+bool saadc_claim(saadc_end_cb_t end_cb);
+
+/**@brief Stop sampling, power the SAADC down and give it up. Safe from any context. */
+void saadc_release(void);
+
+#endif
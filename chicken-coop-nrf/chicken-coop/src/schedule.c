@@ -0,0 +1,204 @@
+#include "schedule.h"
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "params.h"
+#include "sun.h"
+
+LOG_MODULE_REGISTER(schedule, LOG_LEVEL_INF);
+
+#define SCHEDULE_SUBTREE "sched"
+
+#define SECONDS_PER_DAY 86400
+
+/* An event is still executed when the time was corrected past it by at most
+ * this much, older ones are skipped.
+ */
+#define SCHEDULE_LATE_LIMIT_S 300
+
+/* Without sunrise or sunset, as in a polar summer or winter, look again later. */
+#define SCHEDULE_RETRY_S (SECONDS_PER_DAY / 2)
+
+static struct schedule_config config = {
+	.enabled = IS_ENABLED(CONFIG_CHICKEN_COOP_SCHEDULE),
+	.latitude = CONFIG_CHICKEN_COOP_LATITUDE,
+	.longitude = CONFIG_CHICKEN_COOP_LONGITUDE,
+	.sunrise_offset = CONFIG_CHICKEN_COOP_SUNRISE_OFFSET,
+	.sunset_offset = CONFIG_CHICKEN_COOP_SUNSET_OFFSET,
+};
+
+/* Settings key, storage and valid range of every value. */
+static const struct param_entry entries[SCHEDULE_CONFIG_COUNT] = {
+	[SCHEDULE_CONFIG_ENABLED] = {
+		"enabled", &config.enabled, PARAM_BOOL, 0, 1
+	},
+	[SCHEDULE_CONFIG_LATITUDE] = {
+		"lat", &config.latitude, PARAM_S16, -9000, 9000
+	},
+	[SCHEDULE_CONFIG_LONGITUDE] = {
+		"lon", &config.longitude, PARAM_S16, -18000, 18000
+	},
+	[SCHEDULE_CONFIG_SUNRISE_OFFSET] = {
+		"rise", &config.sunrise_offset, PARAM_S16, -720, 720
+	},
+	[SCHEDULE_CONFIG_SUNSET_OFFSET] = {
+		"set", &config.sunset_offset, PARAM_S16, -720, 720
+	},
+};
+
+PARAM_TABLE_DEFINE(params, SCHEDULE_SUBTREE, entries);
+
+static schedule_event_cb_t event_cb;
+
+/* UTC time at uptime 0, valid once synced. */
+static struct k_spinlock time_lock;
+static int64_t time_base;
+static bool time_synced;
+
+/* Next event, only touched by the work handler. */
+static int64_t event_time;
+static enum motion_cmd event_cmd;
+
+static bool time_get(int64_t *now)
+{
+	bool synced;
+
+	K_SPINLOCK(&time_lock) {
+		synced = time_synced;
+		*now = time_base + k_uptime_get() / MSEC_PER_SEC;
+	}
+
+	return synced;
+}
+
+/* Earliest event strictly after now. Offsets of up to half a day can move an
+ * event into the neighboring day, so those are looked at as well.
+ */
+static bool next_event(int64_t now, int64_t *time, enum motion_cmd *cmd)
+{
+	int32_t today = now / SECONDS_PER_DAY;
+	bool found = false;
+
+	for (int32_t day = today - 1; day <= today + 2; day++) {
+		int64_t sunrise;
+		int64_t sunset;
+
+		if (sun_times(day, config.latitude, config.longitude, &sunrise, &sunset)) {
+			continue;
+		}
+
+		sunrise += config.sunrise_offset * 60;
+		sunset += config.sunset_offset * 60;
+
+		if (sunrise > now && (!found || sunrise < *time)) {
+			*time = sunrise;
+			*cmd = MOTION_CMD_OPEN;
+			found = true;
+		}
+		if (sunset > now && (!found || sunset < *time)) {
+			*time = sunset;
+			*cmd = MOTION_CMD_CLOSE;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+/* Runs at the planned event and whenever the time or the configuration
+ * changed. In between, the kernel has nothing to wake up for.
+ */
+static void event_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	int64_t now;
+
+	if (!time_get(&now) || !config.enabled) {
+		event_time = 0;
+		return;
+	}
+
+	if (event_time && now >= event_time && now - event_time <= SCHEDULE_LATE_LIMIT_S) {
+		LOG_INF("Scheduled %s", event_cmd == MOTION_CMD_OPEN ? "opening" : "closing");
+		if (event_cb) {
+			event_cb(event_cmd);
+		}
+	}
+
+	if (!next_event(now, &event_time, &event_cmd)) {
+		LOG_WRN("No sunrise or sunset, checking again later");
+		event_time = 0;
+		k_work_reschedule(dwork, K_SECONDS(SCHEDULE_RETRY_S));
+		return;
+	}
+
+	LOG_INF("Next %s in %lld s", event_cmd == MOTION_CMD_OPEN ? "opening" : "closing",
+		event_time - now);
+	k_work_reschedule(dwork, K_SECONDS(event_time - now));
+}
+
+static K_WORK_DELAYABLE_DEFINE(event_work, event_work_handler);
+
+const struct schedule_config *schedule_config_get(void)
+{
+	return &config;
+}
+
+bool schedule_config_valid(enum schedule_config_key key, int32_t value)
+{
+	return param_in_range(&params, key, value);
+}
+
+int schedule_config_set(enum schedule_config_key key, int32_t value)
+{
+	if (!schedule_config_valid(key, value)) {
+		return -EINVAL;
+	}
+
+	param_set(&params, key, value);
+	k_work_reschedule(&event_work, K_NO_WAIT);
+
+	return 0;
+}
+
+void schedule_time_set(int64_t unix_time)
+{
+	K_SPINLOCK(&time_lock) {
+		time_base = unix_time - k_uptime_get() / MSEC_PER_SEC;
+		time_synced = true;
+	}
+
+	k_work_reschedule(&event_work, K_NO_WAIT);
+}
+
+void schedule_register_event_cb(schedule_event_cb_t cb)
+{
+	event_cb = cb;
+}
+
+static int schedule_settings_set(const char *name, size_t len,
+				 settings_read_cb read_cb, void *cb_arg)
+{
+	int key;
+	int32_t value;
+	int rc = param_read(&params, name, len, read_cb, cb_arg, &key, &value);
+
+	if (rc) {
+		return rc;
+	}
+
+	if (!param_in_range(&params, key, value)) {
+		LOG_WRN("Ignoring stored %s: %d", entries[key].name, value);
+		return 0;
+	}
+
+	param_value_set(&params, key, value);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(schedule, SCHEDULE_SUBTREE, NULL,
+			       schedule_settings_set, NULL, NULL);
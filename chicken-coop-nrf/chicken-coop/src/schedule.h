@@ -0,0 +1,75 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "motion.h"
+
+/* Opens the door at sunrise and closes it at sunset, computed on the device
+ * from its location, so the coop keeps working while the network is down.
+ * Nothing happens until the time of day is known from schedule_time_set().
+ */
+
+/* Schedule parameters that can be tuned at runtime. */
+enum schedule_config_key {
+	/* Whether the door follows the sun. */
+	SCHEDULE_CONFIG_ENABLED,
+	/* Latitude [0.01 deg], north positive. */
+	SCHEDULE_CONFIG_LATITUDE,
+	/* Longitude [0.01 deg], east positive. */
+	SCHEDULE_CONFIG_LONGITUDE,
+	/* Opening time relative to sunrise [min]. */
+	SCHEDULE_CONFIG_SUNRISE_OFFSET,
+	/* Closing time relative to sunset [min]. */
+	SCHEDULE_CONFIG_SUNSET_OFFSET,
+	SCHEDULE_CONFIG_COUNT,
+};
+
+struct schedule_config {
+	bool enabled;
+	int16_t latitude;
+	int16_t longitude;
+	int16_t sunrise_offset;
+	int16_t sunset_offset;
+};
+
+/**@brief Callback running a scheduled door command.
+ *
+ * Called from the system workqueue.
+ *
+ * @param[in]   cmd   MOTION_CMD_OPEN or MOTION_CMD_CLOSE.
+ */
+typedef void (*schedule_event_cb_t)(enum motion_cmd cmd);
+
+/**@brief Get the configuration.
+ *
+ * Loaded from settings by settings_load(), starting from the Kconfig defaults.
+ */
+const struct schedule_config *schedule_config_get(void);
+
+/**@brief Change a value, persist it and plan the next event again.
+ *
+ * @param[in]   key     Value to change.
+ * @param[in]   value   New value.
+ *
+ * @retval 0        Value changed.
+ * @retval -EINVAL  Value out of range.
+ */
+int schedule_config_set(enum schedule_config_key key, int32_t value);
+
+/**@brief Check whether a value is in range without changing anything. */
+bool schedule_config_valid(enum schedule_config_key key, int32_t value);
+
+/**@brief Set the current time and plan the next event.
+ *
+ * The time is kept by the uptime clock in between, call again from time to
+ * time to correct its drift.
+ *
+ * @param[in]   unix_time   Current UTC time [s since 1970-01-01].
+ */
+void schedule_time_set(int64_t unix_time);
+
+void schedule_register_event_cb(schedule_event_cb_t cb);
+
+#endif
@@ -0,0 +1,113 @@
+#include "sim_bench.h"
+#include "motion.h"
+#include "stepper_sim.h"
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+/* Longest a move may take before the run is given up. */
+#define BENCH_MOVE_TIMEOUT_MS 60000
+
+/* Latency buckets by powers of two, the last one takes everything longer. */
+#define BENCH_HIST_BUCKETS 16
+
+#define BENCH_MOVES (2 * CONFIG_CHICKEN_COOP_SIM_BENCH_CYCLES)
+
+struct bench_move {
+	/* From the command to the first step [us]. */
+	uint32_t latency;
+	/* From the command to the last step [us]. */
+	uint32_t travel;
+	uint32_t error_max;
+	uint32_t error_mean;
+};
+
+static struct bench_move moves[BENCH_MOVES];
+
+static int bench_move(enum motion_cmd cmd, enum door_state target, struct bench_move *result)
+{
+	struct stepper_sim_move sim;
+	int64_t start = k_uptime_ticks();
+	int64_t timeout = k_uptime_get() + BENCH_MOVE_TIMEOUT_MS;
+
+	motion_submit(cmd, 0);
+
+	do {
+		if (k_uptime_get() > timeout) {
+			return -ETIMEDOUT;
+		}
+		k_sleep(K_MSEC(1));
+	} while (motion_state_get() != target);
+
+	stepper_sim_last_move(&sim);
+
+	result->latency = k_ticks_to_us_floor32(sim.first - start);
+	result->travel = k_ticks_to_us_floor32(sim.last - start);
+	result->error_max = sim.error_max;
+	result->error_mean = sim.steps > 1 ? sim.error_sum / (sim.steps - 1) : 0;
+
+	return 0;
+}
+
+static int latency_cmp(const void *a, const void *b)
+{
+	uint32_t la = ((const struct bench_move *)a)->latency;
+	uint32_t lb = ((const struct bench_move *)b)->latency;
+
+	return (la > lb) - (la < lb);
+}
+
+void sim_bench_run(void)
+{
+	struct bench_move warmup;
+	uint32_t hist[BENCH_HIST_BUCKETS] = { 0 };
+	uint32_t travel_open = 0;
+	uint32_t travel_close = 0;
+	uint32_t error_max = 0;
+	uint64_t error_mean = 0;
+
+	/* Homes the door first, not counted. */
+	if (bench_move(MOTION_CMD_CLOSE, DOOR_STATE_CLOSED, &warmup)) {
+		printk("bench failed: no home\n");
+		return;
+	}
+
+	for (int i = 0; i < BENCH_MOVES; i++) {
+		bool opening = !(i & 1);
+
+		if (bench_move(opening ? MOTION_CMD_OPEN : MOTION_CMD_CLOSE,
+			       opening ? DOOR_STATE_OPEN : DOOR_STATE_CLOSED, &moves[i])) {
+			printk("bench failed: move %d timed out\n", i);
+			return;
+		}
+
+		uint32_t latency = moves[i].latency;
+		int bucket = latency ? 32 - __builtin_clz(latency) : 0;
+
+		hist[MIN(bucket, BENCH_HIST_BUCKETS - 1)]++;
+		if (opening) {
+			travel_open = MAX(travel_open, moves[i].travel);
+		} else {
+			travel_close = MAX(travel_close, moves[i].travel);
+		}
+		error_max = MAX(error_max, moves[i].error_max);
+		error_mean += moves[i].error_mean;
+	}
+
+	qsort(moves, BENCH_MOVES, sizeof(moves[0]), latency_cmp);
+
+	/* One line of JSON, to be diffed between firmware revisions. */
+	printk("BENCH {\"moves\":%d,\"latency_us\":{\"min\":%u,\"p50\":%u,\"p90\":%u,"
+	       "\"max\":%u,\"hist_log2\":[", BENCH_MOVES, moves[0].latency,
+	       moves[BENCH_MOVES / 2].latency, moves[BENCH_MOVES * 9 / 10].latency,
+	       moves[BENCH_MOVES - 1].latency);
+	for (int i = 0; i < BENCH_HIST_BUCKETS; i++) {
+		printk("%s%u", i ? "," : "", hist[i]);
+	}
+	printk("]},\"step_error_us\":{\"mean\":%u,\"max\":%u},"
+	       "\"travel_us\":{\"open\":%u,\"close\":%u}}\n",
+	       (uint32_t)(error_mean / BENCH_MOVES), error_max, travel_open, travel_close);
+
+	printk("bench done\n");
+}
@@ -0,0 +1,19 @@
+#ifndef SIM_BENCH_H
+#define SIM_BENCH_H
+
+/* Door benchmark of the native_sim build. Without
+ * CONFIG_CHICKEN_COOP_SIM_BENCH the call does nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_SIM_BENCH
+
+/**@brief Open and close the virtual door and print the timing, once the motion thread runs. */
+void sim_bench_run(void);
+
+#else
+
+static inline void sim_bench_run(void) {}
+
+#endif
+
+#endif
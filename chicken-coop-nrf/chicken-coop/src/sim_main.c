@@ -0,0 +1,196 @@
+/** @file
+ *
+ * @brief Build of the coop with a virtual door, for native_sim or QEMU.
+ *
+ * Stands in for main.c and the Zigbee stack. The door clusters are the
+ * ones of the device, coop_zcl.c, on top of zcl_shim_sim.c. The shell
+ * commands hand them the device callbacks and attribute writes ZBOSS would
+ * pass on for the ZCL commands. The door logic, the planner and the sun
+ * schedule are the same as on the device, the steps go to the virtual door
+ * of stepper_sim.c.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "boot_time.h"
+#include "coop_zcl.h"
+#include "motion.h"
+#include "schedule.h"
+#include "sim_bench.h"
+
+LOG_MODULE_REGISTER(app, LOG_LEVEL_INF);
+
+/**@brief Pass a device callback to the door clusters, as ZBOSS would from the Zigbee thread. */
+static int device_cb_run(const struct shell *sh, zb_zcl_device_callback_param_t *param)
+{
+	zb_bool_t handled;
+
+	param->endpoint = CHICKEN_COOP_ENDPOINT;
+
+	zcl_shim_sim_lock();
+	handled = coop_zcl_device_cb(param);
+	zcl_shim_sim_unlock();
+
+	if (!handled || param->status != RET_OK) {
+		shell_error(sh, "Command failed (status: %d)", handled ? param->status : -1);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int on_off_write(const struct shell *sh, zb_bool_t on)
+{
+	zb_zcl_device_callback_param_t param = {
+		.device_cb_id = ZB_ZCL_SET_ATTR_VALUE_CB_ID,
+		.cb_param.set_attr_value_param = {
+			.cluster_id = ZB_ZCL_CLUSTER_ID_ON_OFF,
+			.attr_id = ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
+			.values.data8 = on,
+		},
+	};
+
+	return device_cb_run(sh, &param);
+}
+
+static int cmd_open(const struct shell *sh, size_t argc, char **argv)
+{
+	return on_off_write(sh, ZB_TRUE);
+}
+
+static int cmd_close(const struct shell *sh, size_t argc, char **argv)
+{
+	return on_off_write(sh, ZB_FALSE);
+}
+
+static int cmd_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	zb_zcl_device_callback_param_t param = {
+		.device_cb_id = ZB_ZCL_WINDOW_COVERING_STOP_CB_ID,
+	};
+
+	return device_cb_run(sh, &param);
+}
+
+static int cmd_lift(const struct shell *sh, size_t argc, char **argv)
+{
+	zb_zcl_device_callback_param_t param = {
+		.device_cb_id = ZB_ZCL_WINDOW_COVERING_GO_TO_LIFT_PERCENTAGE_CB_ID,
+		.cb_param.go_to_lift_percentage.percentage_lift_value = strtoul(argv[1], NULL, 0),
+	};
+
+	return device_cb_run(sh, &param);
+}
+
+static int cmd_calibrate(const struct shell *sh, size_t argc, char **argv)
+{
+	zcl_shim_sim_lock();
+	coop_zcl_calibrate(0);
+	zcl_shim_sim_unlock();
+
+	return 0;
+}
+
+/* A Write Attributes command to the coop configuration cluster, checked,
+ * stored and then applied in the order of ZBOSS.
+ */
+static int cmd_write(const struct shell *sh, size_t argc, char **argv)
+{
+	zb_uint16_t attr_id = strtoul(argv[1], NULL, 0);
+	zb_uint8_t value[sizeof(zb_uint32_t)];
+	zb_ret_t status;
+
+	/* Little endian, the attribute takes as many bytes as it needs. */
+	sys_put_le32(strtol(argv[2], NULL, 0), value);
+
+	zcl_shim_sim_lock();
+	status = coop_zcl_config_check_value(attr_id, CHICKEN_COOP_ENDPOINT, value);
+	if (status == RET_OK) {
+		zcl_shim_attr_set(ZB_ZCL_CLUSTER_ID_COOP_CONFIG, attr_id,
+				  ZB_ZCL_COOP_CONFIG_MANUF_CODE, value);
+		coop_zcl_config_write(CHICKEN_COOP_ENDPOINT, attr_id, value,
+				      ZB_ZCL_COOP_CONFIG_MANUF_CODE);
+	}
+	zcl_shim_sim_unlock();
+
+	if (status != RET_OK) {
+		shell_error(sh, "Invalid value");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int cmd_time(const struct shell *sh, size_t argc, char **argv)
+{
+	schedule_time_set(strtoll(argv[1], NULL, 0));
+
+	return 0;
+}
+
+static int cmd_attr(const struct shell *sh, size_t argc, char **argv)
+{
+	zcl_shim_sim_lock();
+	shell_print(sh, "on/off %u, lift %u%%, door state %u, position error %d, "
+		    "travel %u, alarms %u, uptime %lld ms",
+		    coop_zcl_ctx.on_off_attr.on_off,
+		    coop_zcl_ctx.window_covering_attr.current_position_lift_percentage,
+		    coop_zcl_ctx.coop_config_attr.door_state,
+		    coop_zcl_ctx.coop_config_attr.position_error,
+		    coop_zcl_ctx.coop_config_attr.travel_steps,
+		    zcl_shim_sim_alarms(), k_uptime_get());
+	zcl_shim_sim_unlock();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(zcl_cmds,
+	SHELL_CMD(open, NULL, "On/Off on", cmd_open),
+	SHELL_CMD(close, NULL, "On/Off off", cmd_close),
+	SHELL_CMD(stop, NULL, "Window Covering stop", cmd_stop),
+	SHELL_CMD_ARG(lift, NULL, "Window Covering go to <lift percentage>", cmd_lift, 2, 0),
+	SHELL_CMD(calibrate, NULL, "Coop configuration calibrate", cmd_calibrate),
+	SHELL_CMD_ARG(write, NULL, "Coop configuration write <attribute id> <value>",
+		      cmd_write, 3, 0),
+	SHELL_CMD_ARG(time, NULL, "Time cluster answer <unix time>", cmd_time, 2, 0),
+	SHELL_CMD(attr, NULL, "Attributes of the door clusters", cmd_attr),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((coop), zcl, &zcl_cmds, "Commands of the Zigbee clusters", NULL, 1, 0);
+
+int main(void)
+{
+	boot_time_mark(BOOT_PHASE_MAIN);
+
+	LOG_INF("Starting simulated Chicken coop");
+
+	int err = settings_subsys_init();
+
+	if (err) {
+		LOG_ERR("settings initialization failed");
+	}
+	boot_time_mark(BOOT_PHASE_SETTINGS_INIT);
+
+	coop_zcl_init();
+
+	err = settings_load();
+	if (err) {
+		LOG_ERR("settings loading failed");
+	}
+	boot_time_mark(BOOT_PHASE_SETTINGS_LOADED);
+
+	coop_zcl_config_attr_init();
+
+	motion_start();
+
+	sim_bench_run();
+
+	return 0;
+}
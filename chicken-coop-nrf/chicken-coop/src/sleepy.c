@@ -0,0 +1,69 @@
+#include "sleepy.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zboss_api.h>
+#include <zigbee/zigbee_app_utils.h>
+
+LOG_MODULE_REGISTER(sleepy, LOG_LEVEL_INF);
+
+/* Poll Control attributes count in quarter seconds. */
+#define QS_PER_S 4
+#define MS_PER_QS 250
+
+static zb_uint32_t checkin_interval = CONFIG_CHICKEN_COOP_CHECKIN_INTERVAL * QS_PER_S;
+static zb_uint32_t long_poll_interval = CONFIG_CHICKEN_COOP_LONG_POLL_INTERVAL / MS_PER_QS;
+static zb_uint16_t short_poll_interval = CONFIG_CHICKEN_COOP_FAST_POLL_INTERVAL / MS_PER_QS;
+static zb_uint16_t fast_poll_timeout = CONFIG_CHICKEN_COOP_FAST_POLL_TIMEOUT * QS_PER_S;
+static zb_uint32_t checkin_interval_min = ZB_ZCL_POLL_CONTROL_CHECKIN_INTERVAL_MIN_VALUE;
+static zb_uint32_t long_poll_interval_min = ZB_ZCL_POLL_CONTROL_LONG_POLL_INTERVAL_MIN_VALUE;
+static zb_uint16_t fast_poll_timeout_max = ZB_ZCL_POLL_CONTROL_FAST_POLL_TIMEOUT_MAX_VALUE;
+
+ZB_ZCL_DECLARE_POLL_CONTROL_ATTRIB_LIST(
+	poll_control_attr_list,
+	&checkin_interval,
+	&long_poll_interval,
+	&short_poll_interval,
+	&fast_poll_timeout,
+	&checkin_interval_min,
+	&long_poll_interval_min,
+	&fast_poll_timeout_max);
+
+void sleepy_init(void)
+{
+	/* Radio off between polls, and RAM not in use powered down in sleep. */
+	zigbee_configure_sleepy_behavior(true);
+
+	zb_zdo_pim_set_long_poll_interval(CONFIG_CHICKEN_COOP_LONG_POLL_INTERVAL);
+	zb_zdo_pim_set_fast_poll_interval(CONFIG_CHICKEN_COOP_FAST_POLL_INTERVAL);
+	zb_zdo_pim_set_fast_poll_timeout(CONFIG_CHICKEN_COOP_FAST_POLL_TIMEOUT * MSEC_PER_SEC);
+}
+
+static void poll_control_start(zb_bufid_t bufid, zb_uint16_t endpoint)
+{
+	zb_ret_t zb_err_code = zb_zcl_poll_control_start(bufid, endpoint);
+
+	if (zb_err_code != RET_OK) {
+		LOG_ERR("Cannot start Poll Control check-ins (err: %d)", zb_err_code);
+	}
+}
+
+void sleepy_network_joined(zb_uint8_t endpoint)
+{
+	zb_ret_t zb_err_code = zb_buf_get_out_delayed_ext(poll_control_start, endpoint, 0);
+
+	if (zb_err_code != RET_OK) {
+		LOG_ERR("Cannot start Poll Control check-ins (err: %d)", zb_err_code);
+	}
+}
+
+void sleepy_fast_poll_start(void)
+{
+	/* Restarts the fast poll timeout when already fast polling. */
+	zb_zdo_pim_start_fast_poll(0);
+}
+
+void sleepy_fast_poll_stop(void)
+{
+	zb_zdo_pim_stop_fast_poll(0);
+}
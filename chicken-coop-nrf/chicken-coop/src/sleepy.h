@@ -0,0 +1,47 @@
+#ifndef SLEEPY_H
+#define SLEEPY_H
+
+/* Sleepy end device support. The radio sleeps between polls of the parent,
+ * long polls while idle and fast polls while the door has work to do.
+ * Without CONFIG_CHICKEN_COOP_SLEEPY the device is a router with the radio
+ * always on and these calls do nothing.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_SLEEPY
+
+#include <zboss_api.h>
+
+/* Attribute list of the Poll Control cluster, part of the coop endpoint. */
+extern zb_zcl_attr_t poll_control_attr_list[];
+
+/**@brief Configure sleepy behavior, must be called before zigbee_enable(). */
+void sleepy_init(void);
+
+/**@brief Start the Poll Control check-ins once joined, from the Zigbee thread.
+ *
+ * @param[in]   endpoint   Endpoint hosting the Poll Control cluster.
+ */
+void sleepy_network_joined(zb_uint8_t endpoint);
+
+/**@brief Poll fast while the door has work to do, from the Zigbee thread.
+ *
+ * Fast polling ends by itself after CONFIG_CHICKEN_COOP_FAST_POLL_TIMEOUT in
+ * case sleepy_fast_poll_stop() is never called.
+ */
+void sleepy_fast_poll_start(void);
+
+/**@brief Go back to long polling, from the Zigbee thread. */
+void sleepy_fast_poll_stop(void);
+
+#else
+
+#include <stdint.h>
+
+static inline void sleepy_init(void) {}
+static inline void sleepy_network_joined(uint8_t endpoint) {}
+static inline void sleepy_fast_poll_start(void) {}
+static inline void sleepy_fast_poll_stop(void) {}
+
+#endif
+
+#endif
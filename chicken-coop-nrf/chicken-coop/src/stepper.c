@@ -1,45 +1,300 @@
 #include "stepper.h"
+#include "stepper_backend.h"
+#include "stepper_io.h"
+#include "current.h"
+#include "encoder.h"
+#include "jitter.h"
+#include "planner.h"
 
-#include <hal/nrf_gpio.h>
+#include <errno.h>
 #include <zephyr/kernel.h>
 
-void stepper_init(void)
+static stepper_done_cb_t move_done_cb;
+static struct planner_move move;
+static volatile bool busy;
+static bool move_dir;
+static volatile bool endstop_hit;
+static volatile bool stop_requested;
+static volatile bool stalled;
+
+static int32_t position;
+static bool position_known;
+static int32_t position_error;
+
+static void endstop_handler(bool dir)
 {
-    nrf_gpio_cfg_output(motor_step);
-    nrf_gpio_cfg_output(motor_dir);
-    nrf_gpio_cfg_output(motor_enable);
+	/* Only the endstop ahead of the door matters, the other one is just being left. */
+	if (!busy || dir != move_dir) {
+		return;
+	}
+
+	endstop_hit = true;
+	stepper_backend_abort();
+}
+
+static void stall_handler(void)
+{
+	if (!busy) {
+		return;
+	}
+
+	stalled = true;
+	stepper_backend_abort();
+}
+
+int stepper_init(void)
+{
+	int err = planner_init();
+
+	if (err) {
+		return err;
+	}
+
+	err = stepper_backend_init();
+	if (err) {
+		return err;
+	}
+
+	err = current_sense_init();
+	if (err) {
+		return err;
+	}
 
-	// Set the direction
-	nrf_gpio_pin_set(motor_dir);
+	err = encoder_init();
+	if (err) {
+		return err;
+	}
+
+	err = jitter_init();
+	if (err) {
+		return err;
+	}
+
+	return stepper_io_init(endstop_handler);
+}
+
+bool stepper_is_busy(void)
+{
+	return busy;
+}
+
+bool stepper_position_known(void)
+{
+	return position_known;
+}
+
+void stepper_position_restore(int32_t restored)
+{
+	position = restored;
+	position_known = true;
+}
+
+void stepper_position_forget(void)
+{
+	position_known = false;
+}
+
+bool stepper_emergency_stop(int32_t *now)
+{
+	stepper_stop();
 
 	// Disable the motor
-	nrf_gpio_pin_set(motor_enable);
-}
-
-void stepper_run(bool dir)
-{
-    // Enable the motor
-    nrf_gpio_pin_clear(motor_enable);
-
-    // Set the direction based on input
-    if (dir)
-    {
-        nrf_gpio_pin_set(motor_dir);
-    }
-    else
-    {
-        nrf_gpio_pin_clear(motor_dir);
-    }
-
-    // Run the motors
-    for (int i = 0; i < steps_to_endstop; i++)
-    {
-        nrf_gpio_pin_set(motor_step);
-        k_usleep(stepper_speed);
-        nrf_gpio_pin_clear(motor_step);
-        k_usleep(stepper_speed);
-    }
-
-    // Disable motor
-    nrf_gpio_pin_set(motor_enable);
-}
\ No newline at end of file
+	stepper_io_enable(false);
+
+	*now = stepper_position_get();
+
+	return position_known;
+}
+
+int32_t stepper_position_error(void)
+{
+	return position_error;
+}
+
+int32_t stepper_position_get(void)
+{
+	unsigned int key = irq_lock();
+	int32_t now = position;
+
+	/* Add the progress of the move in progress, the position itself is only
+	 * updated once the move is done.
+	 */
+	if (busy) {
+		int32_t steps = stepper_backend_steps();
+
+		now += move_dir ? steps : -steps;
+	}
+	irq_unlock(key);
+
+	return now;
+}
+
+void stepper_backend_done(uint32_t steps)
+{
+	stepper_done_cb_t cb = move_done_cb;
+	enum stepper_result result = endstop_hit ? STEPPER_ENDSTOP :
+				     stalled ? STEPPER_STALL :
+				     stop_requested ? STEPPER_STOPPED : STEPPER_DONE;
+	unsigned int key = irq_lock();
+
+	/* The endstop and the end of the move can race, report only once. */
+	if (!busy) {
+		irq_unlock(key);
+		return;
+	}
+	busy = false;
+	irq_unlock(key);
+
+	stepper_io_endstop_disarm();
+	current_sense_stop();
+	jitter_stop();
+
+	int32_t travelled = move_dir ? (int32_t)steps : -(int32_t)steps;
+
+	/* The encoder knows where the door went, missed steps included. */
+	if (IS_ENABLED(CONFIG_CHICKEN_COOP_ENCODER)) {
+		int32_t measured = encoder_stop();
+
+		position_error = measured - travelled;
+		travelled = measured;
+	}
+
+	position += travelled;
+
+	if (result == STEPPER_ENDSTOP && !move_dir) {
+		/* The closed endstop is the reference for the absolute position. */
+		position = 0;
+		position_known = true;
+	} else if (result == STEPPER_STALL && !IS_ENABLED(CONFIG_CHICKEN_COOP_ENCODER)) {
+		/* Steps may have been lost against the obstacle. */
+		position_known = false;
+	}
+
+	if (cb) {
+		cb(steps, result);
+	}
+}
+
+static int move_start(bool dir, stepper_done_cb_t done_cb)
+{
+	unsigned int key = irq_lock();
+
+	if (busy) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	if (stepper_io_endstop_active(dir)) {
+		irq_unlock(key);
+		if (!dir) {
+			position = 0;
+			position_known = true;
+		}
+		return -EALREADY;
+	}
+
+	busy = true;
+	irq_unlock(key);
+
+	move_done_cb = done_cb;
+	move_dir = dir;
+	endstop_hit = false;
+	stop_requested = false;
+	stalled = false;
+
+	// Enable the motor
+	stepper_io_enable(true);
+
+	// Set the direction based on input
+	stepper_io_dir(dir);
+
+	stepper_io_endstop_arm(dir);
+	current_sense_start(stepper_backend_step_event(), stall_handler);
+	jitter_start(stepper_backend_step_event(), &move);
+	encoder_start();
+
+	// Run the motors
+	stepper_backend_start(&move);
+
+	return 0;
+}
+
+int stepper_move_async(uint32_t steps, bool dir, stepper_done_cb_t done_cb)
+{
+	if (steps == 0) {
+		return -EINVAL;
+	}
+
+	if (busy) {
+		return -EBUSY;
+	}
+
+	planner_plan(&move, steps);
+
+	return move_start(dir, done_cb);
+}
+
+void stepper_release(void)
+{
+	if (busy) {
+		return;
+	}
+
+	// Disable the motor
+	stepper_io_enable(false);
+}
+
+void stepper_stop(void)
+{
+	if (!busy) {
+		return;
+	}
+
+	stop_requested = true;
+	stepper_backend_abort();
+}
+
+void stepper_decelerate(void)
+{
+	unsigned int key = irq_lock();
+
+	if (!busy) {
+		irq_unlock(key);
+		return;
+	}
+
+	/* The interval following the step in progress may already be set up
+	 * by the backend, the deceleration starts with the next one.
+	 */
+	uint32_t from_step = stepper_backend_steps() + 1;
+
+	if (planner_decelerate(&move, from_step)) {
+		stop_requested = true;
+		stepper_backend_decelerate(from_step);
+	}
+
+	irq_unlock(key);
+}
+
+int stepper_seek(bool dir, uint32_t max_steps, stepper_done_cb_t done_cb)
+{
+	if (busy) {
+		return -EBUSY;
+	}
+
+	/* Approach at start speed, the endstop stops the door without a ramp. */
+	planner_plan_slow(&move, max_steps);
+
+	return move_start(dir, done_cb);
+}
+
+int stepper_home(uint32_t max_steps, stepper_done_cb_t done_cb)
+{
+	if (busy) {
+		return -EBUSY;
+	}
+
+	position_known = false;
+
+	return stepper_seek(false, max_steps, done_cb);
+}
@@ -2,16 +2,145 @@
 #define STEPPER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // #define NRF_GPIO_PIN_MAP(port, pin)   ((port << 5) | (pin & 0x1F))
 
 #define motor_step NRF_GPIO_PIN_MAP(1, 4)
 #define motor_dir NRF_GPIO_PIN_MAP(1, 7)
 #define motor_enable NRF_GPIO_PIN_MAP(1, 10)
-#define steps_to_endstop 100
-#define stepper_speed 800 // 800us between steps
 
-void stepper_init();
-void stepper_run(bool dir);
+/* Limit switches, active low. Moving with dir == true runs towards endstop_open. */
+#define endstop_open NRF_GPIO_PIN_MAP(1, 11)
+#define endstop_closed NRF_GPIO_PIN_MAP(1, 12)
 
-#endif
\ No newline at end of file
+/* Width of the high part of every step pulse. */
+#define stepper_pulse_width 10 // 10us
+
+/* Why a move ended. */
+enum stepper_result {
+	/* All requested steps were generated. */
+	STEPPER_DONE,
+	/* The endstop in the direction of travel was reached. */
+	STEPPER_ENDSTOP,
+	/* The move was cut short by stepper_stop(). */
+	STEPPER_STOPPED,
+	/* The motor current stayed above the stall limit, the door is blocked. */
+	STEPPER_STALL,
+};
+
+/**@brief Callback invoked when an asynchronous move has finished.
+ *
+ * Called from interrupt context.
+ *
+ * @param[in]   steps    Number of step pulses that were generated.
+ * @param[in]   result   Reason the move ended.
+ */
+typedef void (*stepper_done_cb_t)(uint32_t steps, enum stepper_result result);
+
+int stepper_init(void);
+
+/**@brief Start a move without waiting for it to finish.
+ *
+ * Step pulses are generated in hardware by the backend selected with
+ * CONFIG_CHICKEN_COOP_STEPPER_BACKEND, following the precomputed ramp.
+ * Reaching the endstop in the direction of travel halts the pulses in
+ * hardware, within the current step. With CONFIG_CHICKEN_COOP_CURRENT_SENSE
+ * a stalled motor halts them within a few steps. Waits for the SAADC if the
+ * light sensor is sampling, so only call it from thread context.
+ *
+ * @param[in]   steps     Number of steps to generate.
+ * @param[in]   dir       Direction of the move.
+ * @param[in]   done_cb   Callback called once the last step was generated, may be NULL.
+ *
+ * @retval 0          Move started.
+ * @retval -EBUSY     Another move is still in progress.
+ * @retval -EINVAL    Zero steps requested.
+ * @retval -EALREADY  Already at the endstop in the direction of travel.
+ */
+int stepper_move_async(uint32_t steps, bool dir, stepper_done_cb_t done_cb);
+
+/**@brief Move slowly towards the closed endstop and make it position 0.
+ *
+ * @param[in]   max_steps   Give up if the endstop was not found within this many steps.
+ * @param[in]   done_cb     Callback called when homing ends, may be NULL.
+ *                          Homing failed unless the result is STEPPER_ENDSTOP.
+ *
+ * @retval 0  Homing started, or -errno as for stepper_move_async().
+ */
+int stepper_home(uint32_t max_steps, stepper_done_cb_t done_cb);
+
+/**@brief Move slowly towards an endstop, keeping the position.
+ *
+ * @param[in]   dir         Direction of the move.
+ * @param[in]   max_steps   Give up if the endstop was not found within this many steps.
+ * @param[in]   done_cb     Callback called when the move ends, may be NULL.
+ *                          The endstop was found if the result is STEPPER_ENDSTOP.
+ *
+ * @retval 0  Move started, or -errno as for stepper_move_async().
+ */
+int stepper_seek(bool dir, uint32_t max_steps, stepper_done_cb_t done_cb);
+
+/**@brief Cut the motor current.
+ *
+ * The motor keeps holding its position after a move until this is called.
+ */
+void stepper_release(void);
+
+/**@brief Halt the move in progress right away.
+ *
+ * The done callback of the move reports STEPPER_STOPPED.
+ */
+void stepper_stop(void);
+
+/**@brief Ramp the move in progress down from its current speed.
+ *
+ * The door stops as soon as it can without losing steps. The done callback
+ * of the move reports STEPPER_STOPPED, or STEPPER_DONE if the move was about
+ * to end anyway.
+ */
+void stepper_decelerate(void);
+
+bool stepper_is_busy(void);
+
+/**@brief Whether the absolute position is known, i.e. the door has been homed. */
+bool stepper_position_known(void);
+
+/**@brief Absolute position in steps, 0 being the closed endstop.
+ *
+ * Follows the door while a move is in progress.
+ */
+int32_t stepper_position_get(void);
+
+/**@brief Take the position from elsewhere, e.g. saved before a reset.
+ *
+ * Only call it while no move is in progress.
+ */
+void stepper_position_restore(int32_t position);
+
+/**@brief Forget the position, e.g. after steps may have been lost.
+ *
+ * The door has to be homed again. Only call it while no move is in progress.
+ */
+void stepper_position_forget(void);
+
+/**@brief Halt the pulses and cut the motor current right away.
+ *
+ * For the power fail interrupt, the done callback of a move in progress
+ * reports STEPPER_STOPPED.
+ *
+ * @param[out]  position   Absolute position, up to the step in progress.
+ *
+ * @return true if the position is known.
+ */
+bool stepper_emergency_stop(int32_t *position);
+
+/**@brief Encoder position minus step count over the last move.
+ *
+ * Negative while opening or positive while closing means steps were lost.
+ * The position already follows the encoder. Always 0 without
+ * CONFIG_CHICKEN_COOP_ENCODER.
+ */
+int32_t stepper_position_error(void);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef STEPPER_BACKEND_H
+#define STEPPER_BACKEND_H
+
+#include "planner.h"
+
+/* Interface between the generic stepper code and the peripheral generating
+ * the step pulses. Exactly one backend is built, selected with
+ * CONFIG_CHICKEN_COOP_STEPPER_BACKEND.
+ */
+
+int stepper_backend_init(void);
+
+/**@brief Start emitting the step pulses of a planned move.
+ *
+ * Direction and enable pins are already set up by the caller.
+ */
+void stepper_backend_start(const struct planner_move *move);
+
+/**@brief Address of the task that halts the pulses, for the endstops to trigger through PPI. */
+uint32_t stepper_backend_stop_task(void);
+
+/**@brief Address of an event fired once per step, for the current sensing to sample on. */
+uint32_t stepper_backend_step_event(void);
+
+/**@brief Follow a move that was shortened by planner_decelerate().
+ *
+ * Called with interrupts locked.
+ *
+ * @param[in]   from_step   First step whose interval changed.
+ */
+void stepper_backend_decelerate(uint32_t from_step);
+
+/**@brief Stop the move in progress.
+ *
+ * Called from interrupt context once the pulses were halted through the stop
+ * task, or to halt them. The backend reports the steps generated so far with
+ * stepper_backend_done().
+ */
+void stepper_backend_abort(void);
+
+/**@brief Number of steps generated so far by the move in progress.
+ *
+ * Safe to call from thread context while the move runs.
+ */
+uint32_t stepper_backend_steps(void);
+
+/**@brief Report the end of the move, called by the backend from interrupt context. */
+void stepper_backend_done(uint32_t steps);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef STEPPER_IO_H
+#define STEPPER_IO_H
+
+#include <stdbool.h>
+
+/* Motor driver pins and endstops below the generic stepper code. The nRF
+ * build drives the pins of stepper.h, CONFIG_CHICKEN_COOP_SIM a virtual door.
+ */
+
+/**@brief Callback for the endstop in the direction of travel, from interrupt context.
+ *
+ * The pulses have already been halted through the stop task of the backend.
+ *
+ * @param[in]   dir   Direction of the endstop, true for the open one.
+ */
+typedef void (*stepper_io_endstop_cb_t)(bool dir);
+
+/**@brief Set up the pins with the motor disabled. Needs the backend initialized. */
+int stepper_io_init(stepper_io_endstop_cb_t endstop_cb);
+
+/**@brief Switch the motor current on or off. Safe from interrupt context. */
+void stepper_io_enable(bool enable);
+
+void stepper_io_dir(bool dir);
+
+/**@brief Whether the endstop in a direction is pressed. */
+bool stepper_io_endstop_active(bool dir);
+
+/**@brief Halt the pulses as soon as the endstop in a direction is reached. */
+void stepper_io_endstop_arm(bool dir);
+
+/**@brief Ignore both endstops, from interrupt context. */
+void stepper_io_endstop_disarm(void);
+
+#endif
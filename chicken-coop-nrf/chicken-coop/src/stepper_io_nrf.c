@@ -0,0 +1,111 @@
+#include "stepper.h"
+#include "stepper_backend.h"
+#include "stepper_io.h"
+
+#include <errno.h>
+#include <hal/nrf_gpio.h>
+#include <nrfx_gpiote.h>
+#include <helpers/nrfx_gppi.h>
+#include <zephyr/kernel.h>
+
+static stepper_io_endstop_cb_t endstop_cb;
+
+/* PPI channels halting the pulses when an endstop is reached, one per direction. */
+static uint8_t ppi_endstop_open;
+static uint8_t ppi_endstop_closed;
+
+static void endstop_handler(nrfx_gpiote_pin_t pin, nrfx_gpiote_trigger_t trigger, void *context)
+{
+	ARG_UNUSED(trigger);
+	ARG_UNUSED(context);
+
+	endstop_cb(pin == endstop_open);
+}
+
+static int endstop_init(nrfx_gpiote_pin_t pin, uint8_t *ppi_ch)
+{
+	uint8_t in_ch;
+	nrfx_gpiote_input_config_t input_config = {
+		.pull = NRF_GPIO_PIN_PULLUP,
+	};
+	nrfx_gpiote_trigger_config_t trigger_config = {
+		.trigger = NRFX_GPIOTE_TRIGGER_HITOLO,
+		.p_in_channel = &in_ch,
+	};
+	nrfx_gpiote_handler_config_t handler_config = {
+		.handler = endstop_handler,
+	};
+
+	if (nrfx_gpiote_channel_alloc(&in_ch) != NRFX_SUCCESS ||
+	    nrfx_gppi_channel_alloc(ppi_ch) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	if (nrfx_gpiote_input_configure(pin, &input_config, &trigger_config,
+					&handler_config) != NRFX_SUCCESS) {
+		return -EIO;
+	}
+
+	nrfx_gppi_channel_endpoints_setup(*ppi_ch, nrfx_gpiote_in_event_address_get(pin),
+					  stepper_backend_stop_task());
+	nrfx_gpiote_trigger_enable(pin, true);
+
+	return 0;
+}
+
+int stepper_io_init(stepper_io_endstop_cb_t cb)
+{
+	endstop_cb = cb;
+
+	nrf_gpio_cfg_output(motor_step);
+	nrf_gpio_cfg_output(motor_dir);
+	nrf_gpio_cfg_output(motor_enable);
+
+	// Set the direction
+	nrf_gpio_pin_set(motor_dir);
+
+	// Disable the motor
+	nrf_gpio_pin_set(motor_enable);
+
+	int err = endstop_init(endstop_open, &ppi_endstop_open);
+
+	if (err) {
+		return err;
+	}
+
+	return endstop_init(endstop_closed, &ppi_endstop_closed);
+}
+
+void stepper_io_enable(bool enable)
+{
+	/* The driver enable input is active low. */
+	if (enable) {
+		nrf_gpio_pin_clear(motor_enable);
+	} else {
+		nrf_gpio_pin_set(motor_enable);
+	}
+}
+
+void stepper_io_dir(bool dir)
+{
+	if (dir) {
+		nrf_gpio_pin_set(motor_dir);
+	} else {
+		nrf_gpio_pin_clear(motor_dir);
+	}
+}
+
+bool stepper_io_endstop_active(bool dir)
+{
+	return nrf_gpio_pin_read(dir ? endstop_open : endstop_closed) == 0;
+}
+
+void stepper_io_endstop_arm(bool dir)
+{
+	nrfx_gppi_channels_enable(BIT(dir ? ppi_endstop_open : ppi_endstop_closed));
+}
+
+void stepper_io_endstop_disarm(void)
+{
+	nrfx_gppi_channels_disable(BIT(ppi_endstop_open) | BIT(ppi_endstop_closed));
+}
@@ -0,0 +1,228 @@
+#include "stepper.h"
+#include "stepper_backend.h"
+
+#include <errno.h>
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_pwm.h>
+#include <hal/nrf_timer.h>
+#include <helpers/nrfx_gppi.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+/* PWM0 belongs to the Zephyr PWM driver, the step output uses PWM1. */
+#define step_pwm NRF_PWM1
+#define step_pwm_irq PWM1_IRQn
+#define step_pwm_irq_priority 2
+
+/* TIMER4 counts the PWM periods, so an aborted move knows how far it got. */
+#define count_timer NRF_TIMER4
+#define count_now_cc NRF_TIMER_CC_CHANNEL0
+#define count_progress_cc NRF_TIMER_CC_CHANNEL1
+
+/* COUNTERTOP is 15 bits wide, which limits a single interval to ~32 ms at 1 MHz.
+ * The longest interval is the one at start speed, Kconfig keeps it in range.
+ */
+#define step_pwm_max_interval 0x7FFF
+
+BUILD_ASSERT(USEC_PER_SEC / CONFIG_CHICKEN_COOP_START_SPEED <= step_pwm_max_interval,
+	     "Start speed too low for the PWM backend");
+
+/* Every sequence entry is one PWM period, and thus one step: the step pin is
+ * high for the pulse width at the start of the period, and COUNTERTOP sets the
+ * period to the planned interval.
+ *
+ * Sequence 0 holds the acceleration ramp followed by the first cruise step,
+ * whose value ENDDELAY repeats for the rest of the cruise. Sequence 1 holds the
+ * deceleration ramp and the final step. The whole move plays out of RAM with
+ * EasyDMA and raises a single interrupt when it has stopped, either at the end
+ * of the sequences or when an endstop triggered the STOP task.
+ */
+static nrf_pwm_values_wave_form_t seq_accel[CONFIG_CHICKEN_COOP_RAMP_MAX_STEPS + 1];
+/* A move cut short mid-ramp needs one more entry, see decel_play(). */
+static nrf_pwm_values_wave_form_t seq_decel[CONFIG_CHICKEN_COOP_RAMP_MAX_STEPS + 2];
+
+static uint8_t ppi_step_count;
+
+static const struct planner_move *move;
+
+/* A deceleration is waiting for the PWM to stop. */
+static bool decel_pending;
+
+static void step_entry_set(nrf_pwm_values_wave_form_t *entry, uint32_t interval)
+{
+	entry->channel_0 = stepper_pulse_width;
+	entry->channel_1 = 0;
+	entry->channel_2 = 0;
+	__ASSERT_NO_MSG(interval <= step_pwm_max_interval);
+	entry->counter_top = interval;
+}
+
+/* Play the rest of a shortened move from sequence 1, the PWM is stopped.
+ * Returns false if there is nothing left to play.
+ */
+static bool decel_play(void)
+{
+	nrf_timer_task_trigger(count_timer, nrf_timer_capture_task_get(count_now_cc));
+
+	uint32_t step = nrf_timer_cc_get(count_timer, count_now_cc);
+	uint32_t len = 0;
+
+	while (step < move->steps) {
+		step_entry_set(&seq_decel[len++], planner_interval(move, step++));
+	}
+
+	if (len == 0) {
+		return false;
+	}
+
+	nrf_pwm_seq_cnt_set(step_pwm, 1, len * 4);
+	nrf_pwm_loop_set(step_pwm, 0);
+	nrf_pwm_shorts_set(step_pwm, NRF_PWM_SHORT_SEQEND1_STOP_MASK);
+	nrf_pwm_task_trigger(step_pwm, NRF_PWM_TASK_SEQSTART1);
+
+	return true;
+}
+
+static void step_pwm_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (!nrf_pwm_event_check(step_pwm, NRF_PWM_EVENT_STOPPED)) {
+		return;
+	}
+	nrf_pwm_event_clear(step_pwm, NRF_PWM_EVENT_STOPPED);
+
+	if (decel_pending) {
+		decel_pending = false;
+		if (decel_play()) {
+			return;
+		}
+	}
+
+	nrf_timer_task_trigger(count_timer, NRF_TIMER_TASK_STOP);
+	nrf_timer_task_trigger(count_timer, nrf_timer_capture_task_get(count_now_cc));
+
+	stepper_backend_done(nrf_timer_cc_get(count_timer, count_now_cc));
+}
+
+int stepper_backend_init(void)
+{
+	uint32_t pins[NRF_PWM_CHANNEL_COUNT] = {
+		motor_step,
+		NRF_PWM_PIN_NOT_CONNECTED,
+		NRF_PWM_PIN_NOT_CONNECTED,
+		NRF_PWM_PIN_NOT_CONNECTED,
+	};
+
+	nrf_gpio_pin_clear(motor_step);
+
+	nrf_pwm_pins_set(step_pwm, pins);
+	nrf_pwm_configure(step_pwm, NRF_PWM_CLK_1MHz, NRF_PWM_MODE_UP, step_pwm_max_interval);
+	nrf_pwm_decoder_set(step_pwm, NRF_PWM_LOAD_WAVE_FORM, NRF_PWM_STEP_AUTO);
+	nrf_pwm_seq_ptr_set(step_pwm, 0, (uint16_t *)seq_accel);
+	nrf_pwm_seq_ptr_set(step_pwm, 1, (uint16_t *)seq_decel);
+	nrf_pwm_seq_refresh_set(step_pwm, 0, 0);
+	nrf_pwm_seq_refresh_set(step_pwm, 1, 0);
+	nrf_pwm_int_set(step_pwm, NRF_PWM_INT_STOPPED_MASK);
+
+	IRQ_CONNECT(step_pwm_irq, step_pwm_irq_priority, step_pwm_isr, NULL, 0);
+	irq_enable(step_pwm_irq);
+
+	nrf_pwm_enable(step_pwm);
+
+	nrf_timer_mode_set(count_timer, NRF_TIMER_MODE_COUNTER);
+	nrf_timer_bit_width_set(count_timer, NRF_TIMER_BIT_WIDTH_32);
+
+	if (nrfx_gppi_channel_alloc(&ppi_step_count) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	nrfx_gppi_channel_endpoints_setup(ppi_step_count,
+		nrf_pwm_event_address_get(step_pwm, NRF_PWM_EVENT_PWMPERIODEND),
+		nrf_timer_task_address_get(count_timer, NRF_TIMER_TASK_COUNT));
+	nrfx_gppi_channels_enable(BIT(ppi_step_count));
+
+	return 0;
+}
+
+uint32_t stepper_backend_stop_task(void)
+{
+	return nrf_pwm_task_address_get(step_pwm, NRF_PWM_TASK_STOP);
+}
+
+uint32_t stepper_backend_step_event(void)
+{
+	return nrf_pwm_event_address_get(step_pwm, NRF_PWM_EVENT_PWMPERIODEND);
+}
+
+void stepper_backend_decelerate(uint32_t from_step)
+{
+	ARG_UNUSED(from_step);
+
+	/* Sequences cannot be switched mid-play, so halt at the end of the
+	 * current period and let the interrupt play the rest of the move. The
+	 * pin idles low meanwhile, which only stretches one interval a little.
+	 */
+	decel_pending = true;
+	nrf_pwm_task_trigger(step_pwm, NRF_PWM_TASK_STOP);
+}
+
+void stepper_backend_abort(void)
+{
+	decel_pending = false;
+
+	/* Takes effect at the end of the current period, the STOPPED event then reports the steps. */
+	nrf_pwm_task_trigger(step_pwm, NRF_PWM_TASK_STOP);
+}
+
+uint32_t stepper_backend_steps(void)
+{
+	nrf_timer_task_trigger(count_timer, nrf_timer_capture_task_get(count_progress_cc));
+
+	return nrf_timer_cc_get(count_timer, count_progress_cc);
+}
+
+void stepper_backend_start(const struct planner_move *m)
+{
+	move = m;
+	decel_pending = false;
+
+	uint32_t cruise = move->steps - 1 - 2 * move->ramp_steps;
+	uint32_t accel_len = move->ramp_steps;
+	uint32_t step = 0;
+
+	for (uint32_t i = 0; i < move->ramp_steps; i++) {
+		step_entry_set(&seq_accel[i], planner_interval(move, step++));
+	}
+
+	/* The first cruise step goes in as a value, the rest are repeats of it. */
+	if (cruise) {
+		step_entry_set(&seq_accel[accel_len++], planner_interval(move, step));
+		step += cruise;
+	}
+
+	for (uint32_t i = 0; step < move->steps; i++) {
+		step_entry_set(&seq_decel[i], planner_interval(move, step++));
+	}
+
+	nrf_pwm_seq_cnt_set(step_pwm, 1, (move->ramp_steps + 1) * 4);
+	nrf_pwm_event_clear(step_pwm, NRF_PWM_EVENT_STOPPED);
+
+	nrf_timer_task_trigger(count_timer, NRF_TIMER_TASK_CLEAR);
+	nrf_timer_task_trigger(count_timer, NRF_TIMER_TASK_START);
+
+	if (accel_len) {
+		nrf_pwm_seq_cnt_set(step_pwm, 0, accel_len * 4);
+		nrf_pwm_seq_end_delay_set(step_pwm, 0, cruise ? cruise - 1 : 0);
+
+		/* One loop plays sequence 0 followed by sequence 1. */
+		nrf_pwm_loop_set(step_pwm, 1);
+		nrf_pwm_shorts_set(step_pwm, NRF_PWM_SHORT_LOOPSDONE_STOP_MASK);
+		nrf_pwm_task_trigger(step_pwm, NRF_PWM_TASK_SEQSTART0);
+	} else {
+		nrf_pwm_loop_set(step_pwm, 0);
+		nrf_pwm_shorts_set(step_pwm, NRF_PWM_SHORT_SEQEND1_STOP_MASK);
+		nrf_pwm_task_trigger(step_pwm, NRF_PWM_TASK_SEQSTART1);
+	}
+}
@@ -0,0 +1,238 @@
+#include "stepper_backend.h"
+#include "stepper_io.h"
+#include "stepper_sim.h"
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+/* Virtual door of CONFIG_CHICKEN_COOP_SIM. Every step pulse moves the door by one step
+ * while the motor is enabled, the endstops are pressed at the ends of
+ * CONFIG_CHICKEN_COOP_SIM_TRAVEL. A recorder keeps the time of the steps
+ * of the last move.
+ */
+
+static stepper_io_endstop_cb_t endstop_cb;
+
+static struct k_timer step_timer;
+static const struct planner_move *move;
+static uint32_t steps;
+static bool running;
+
+/* Door position in steps, 0 being the closed endstop. */
+static int32_t door;
+static bool enabled;
+static bool move_dir;
+static bool armed[2];
+
+/* Last move, as recorded. */
+static struct stepper_sim_move last;
+static uint32_t at[CONFIG_CHICKEN_COOP_SIM_TRACE_STEPS];
+
+/* Time of the next step from the first one, the sum of the planned
+ * intervals so far [us]. Measured against it, the timer error adds up
+ * over the move instead of starting over at every step.
+ */
+static uint64_t planned;
+
+static bool endstop_active(bool dir)
+{
+	return dir ? door >= CONFIG_CHICKEN_COOP_SIM_TRAVEL : door <= 0;
+}
+
+static void step_expiry(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	if (!running) {
+		return;
+	}
+
+	int64_t now = k_uptime_ticks();
+
+	if (steps == 0) {
+		last.first = now;
+		planned = 0;
+	} else {
+		int64_t actual = k_ticks_to_us_floor64(now - last.first);
+		uint32_t error = llabs(actual - (int64_t)planned);
+
+		last.error_max = MAX(last.error_max, error);
+		last.error_sum += error;
+	}
+	if (steps < ARRAY_SIZE(at)) {
+		at[steps] = k_ticks_to_us_floor32(now - last.first);
+	}
+	last.last = now;
+	steps++;
+	last.steps = steps;
+
+	/* Without current, or against an endstop, the motor skips the step. */
+	if (!enabled || endstop_active(move_dir)) {
+		last.lost++;
+	} else {
+		door += move_dir ? 1 : -1;
+	}
+
+	if (armed[move_dir] && endstop_active(move_dir)) {
+		/* The stop task halted the pulses. */
+		running = false;
+		endstop_cb(move_dir);
+		return;
+	}
+
+	if (steps >= move->steps) {
+		running = false;
+		stepper_backend_done(steps);
+		return;
+	}
+
+	uint32_t interval = planner_interval(move, steps - 1);
+
+	planned += interval;
+	k_timer_start(&step_timer, K_USEC(interval), K_NO_WAIT);
+}
+
+int stepper_backend_init(void)
+{
+	k_timer_init(&step_timer, step_expiry, NULL);
+
+	return 0;
+}
+
+void stepper_backend_start(const struct planner_move *planned)
+{
+	move = planned;
+	steps = 0;
+
+	last = (struct stepper_sim_move){
+		.dir = move_dir,
+	};
+
+	running = true;
+	k_timer_start(&step_timer, K_NO_WAIT, K_NO_WAIT);
+}
+
+uint32_t stepper_backend_stop_task(void)
+{
+	return 0;
+}
+
+uint32_t stepper_backend_step_event(void)
+{
+	return 0;
+}
+
+void stepper_backend_decelerate(uint32_t from_step)
+{
+	/* Every interval is looked up when its step happens. */
+	ARG_UNUSED(from_step);
+}
+
+void stepper_backend_abort(void)
+{
+	unsigned int key = irq_lock();
+
+	running = false;
+	k_timer_stop(&step_timer);
+	irq_unlock(key);
+
+	stepper_backend_done(steps);
+}
+
+uint32_t stepper_backend_steps(void)
+{
+	return steps;
+}
+
+int stepper_io_init(stepper_io_endstop_cb_t cb)
+{
+	endstop_cb = cb;
+
+	return 0;
+}
+
+void stepper_sim_last_move(struct stepper_sim_move *move_out)
+{
+	unsigned int key = irq_lock();
+
+	*move_out = last;
+	irq_unlock(key);
+}
+
+void stepper_io_enable(bool enable)
+{
+	enabled = enable;
+}
+
+void stepper_io_dir(bool dir)
+{
+	move_dir = dir;
+}
+
+bool stepper_io_endstop_active(bool dir)
+{
+	return endstop_active(dir);
+}
+
+void stepper_io_endstop_arm(bool dir)
+{
+	armed[dir] = true;
+}
+
+void stepper_io_endstop_disarm(void)
+{
+	armed[false] = false;
+	armed[true] = false;
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_door(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc > 1) {
+		if (running) {
+			shell_error(sh, "Door is moving");
+			return -EBUSY;
+		}
+
+		/* Moved by hand, e.g. while the coop was off. */
+		door = CLAMP(strtol(argv[1], NULL, 0), 0, CONFIG_CHICKEN_COOP_SIM_TRAVEL);
+	}
+
+	shell_print(sh, "door %d/%d steps, motor %s, endstop %s", door,
+		    CONFIG_CHICKEN_COOP_SIM_TRAVEL, enabled ? "on" : "off",
+		    endstop_active(false) ? "closed" : endstop_active(true) ? "open" : "none");
+
+	return 0;
+}
+
+static int cmd_trace(const struct shell *sh, size_t argc, char **argv)
+{
+	struct stepper_sim_move move_now;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	stepper_sim_last_move(&move_now);
+
+	uint32_t recorded = MIN(move_now.steps, ARRAY_SIZE(at));
+
+	shell_print(sh, "%s, %u steps, %u lost, step error max %u us", move_now.dir ?
+		    "opening" : "closing", move_now.steps, move_now.lost, move_now.error_max);
+
+	for (uint32_t i = 0; i < recorded; i++) {
+		shell_print(sh, "%5u %8u us %+6d us", i, at[i],
+			    i ? (int32_t)(at[i] - at[i - 1]) : 0);
+	}
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sim_cmds,
+	SHELL_CMD_ARG(door, NULL, "Show the virtual door, or put it at [steps]", cmd_door, 1, 1),
+	SHELL_CMD(trace, NULL, "Step times of the last move", cmd_trace),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((coop), sim, &sim_cmds, "Virtual door", NULL, 1, 0);
+#endif
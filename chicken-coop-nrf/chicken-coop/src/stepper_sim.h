@@ -0,0 +1,26 @@
+#ifndef STEPPER_SIM_H
+#define STEPPER_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Recording of the virtual door of the native_sim build. */
+struct stepper_sim_move {
+	bool dir;
+	uint32_t steps;
+	/* Steps the door did not follow, motor off or against an endstop. */
+	uint32_t lost;
+	/* Uptime of the first and the last step [ticks]. */
+	int64_t first;
+	int64_t last;
+	/* Time of a step minus its planned time, the sum of the planned
+	 * intervals since the first step, over all steps but the first [us].
+	 */
+	uint32_t error_max;
+	uint64_t error_sum;
+};
+
+/**@brief Copy the recording of the last move, or of the move in progress. */
+void stepper_sim_last_move(struct stepper_sim_move *move);
+
+#endif
@@ -0,0 +1,244 @@
+#include "stepper.h"
+#include "stepper_backend.h"
+
+#include <errno.h>
+#include <hal/nrf_gpiote.h>
+#include <hal/nrf_timer.h>
+#include <nrfx_gpiote.h>
+#include <helpers/nrfx_gppi.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+
+/* TIMER3 produces the step edges, TIMER4 counts them and ends the move. */
+#define step_timer NRF_TIMER3
+#define step_timer_irq TIMER3_IRQn
+#define step_timer_irq_priority 1
+#define count_timer NRF_TIMER4
+#define count_timer_irq TIMER4_IRQn
+#define count_timer_irq_priority 2
+
+/* 16 MHz / 2^4 gives a 1 us timer tick. */
+#define step_timer_prescaler 4
+
+/* The rising edge of a step happens on COMPARE0, the falling edge on COMPARE1. */
+#define step_interval_cc NRF_TIMER_CC_CHANNEL0
+#define step_pulse_cc NRF_TIMER_CC_CHANNEL1
+#define step_now_cc NRF_TIMER_CC_CHANNEL2
+#define count_done_cc NRF_TIMER_CC_CHANNEL0
+#define count_decel_cc NRF_TIMER_CC_CHANNEL1
+#define count_now_cc NRF_TIMER_CC_CHANNEL2
+#define count_progress_cc NRF_TIMER_CC_CHANNEL3
+
+/* The step interrupt only runs while ramping. It must keep a little margin
+ * to the next compare when it is late, or the timer would have to wrap.
+ */
+#define step_late_margin 2
+
+static uint8_t gpiote_ch;
+static uint8_t ppi_step_set;
+static uint8_t ppi_step_clr;
+static uint8_t ppi_move_done;
+
+static const struct planner_move *move;
+
+static void step_timer_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	nrf_timer_event_clear(step_timer, nrf_timer_compare_event_get(step_interval_cc));
+
+	/* Steps completed so far is the index of the step that just started. */
+	nrf_timer_task_trigger(count_timer, nrf_timer_capture_task_get(count_now_cc));
+	uint32_t step = nrf_timer_cc_get(count_timer, count_now_cc);
+	uint32_t interval = planner_interval(move, step);
+
+	nrf_timer_cc_set(step_timer, step_interval_cc, interval);
+
+	nrf_timer_task_trigger(step_timer, nrf_timer_capture_task_get(step_now_cc));
+	if (nrf_timer_cc_get(step_timer, step_now_cc) + step_late_margin >= interval) {
+		nrf_timer_cc_set(step_timer, step_interval_cc,
+				 nrf_timer_cc_get(step_timer, step_now_cc) + step_late_margin);
+	}
+
+	/* Nothing to update while cruising, the deceleration compare wakes us up again. */
+	if (step == move->ramp_steps &&
+	    move->steps - 1 - 2 * move->ramp_steps >= 2) {
+		nrf_timer_int_disable(step_timer, nrf_timer_compare_int_get(step_interval_cc));
+	}
+}
+
+static void count_timer_isr(const void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (nrf_timer_event_check(count_timer, nrf_timer_compare_event_get(count_decel_cc))) {
+		nrf_timer_event_clear(count_timer, nrf_timer_compare_event_get(count_decel_cc));
+		/* The compare event of the last cruising step is still pending, it
+		 * would run the step interrupt right away, one step early.
+		 */
+		nrf_timer_event_clear(step_timer, nrf_timer_compare_event_get(step_interval_cc));
+		nrf_timer_int_enable(step_timer, nrf_timer_compare_int_get(step_interval_cc));
+	}
+
+	if (!nrf_timer_event_check(count_timer, nrf_timer_compare_event_get(count_done_cc))) {
+		return;
+	}
+	nrf_timer_event_clear(count_timer, nrf_timer_compare_event_get(count_done_cc));
+	nrf_timer_int_disable(step_timer, nrf_timer_compare_int_get(step_interval_cc));
+
+	nrfx_gppi_channels_disable(BIT(ppi_step_set) | BIT(ppi_step_clr) | BIT(ppi_move_done));
+
+	stepper_backend_done(nrf_timer_cc_get(count_timer, count_done_cc));
+}
+
+static void step_timer_init(void)
+{
+	nrf_timer_mode_set(step_timer, NRF_TIMER_MODE_TIMER);
+	nrf_timer_bit_width_set(step_timer, NRF_TIMER_BIT_WIDTH_32);
+	nrf_timer_prescaler_set(step_timer, step_timer_prescaler);
+	nrf_timer_cc_set(step_timer, step_pulse_cc, stepper_pulse_width);
+	nrf_timer_shorts_enable(step_timer, NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK);
+
+	IRQ_CONNECT(step_timer_irq, step_timer_irq_priority, step_timer_isr, NULL, 0);
+	irq_enable(step_timer_irq);
+
+	nrf_timer_mode_set(count_timer, NRF_TIMER_MODE_COUNTER);
+	nrf_timer_bit_width_set(count_timer, NRF_TIMER_BIT_WIDTH_32);
+	nrf_timer_shorts_enable(count_timer, NRF_TIMER_SHORT_COMPARE0_STOP_MASK |
+					     NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK);
+	nrf_timer_int_enable(count_timer, nrf_timer_compare_int_get(count_done_cc) |
+					  nrf_timer_compare_int_get(count_decel_cc));
+
+	IRQ_CONNECT(count_timer_irq, count_timer_irq_priority, count_timer_isr, NULL, 0);
+	irq_enable(count_timer_irq);
+}
+
+static int step_ppi_init(void)
+{
+	if (nrfx_gpiote_channel_alloc(&gpiote_ch) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	nrf_gpiote_task_configure(NRF_GPIOTE, gpiote_ch, motor_step,
+				  NRF_GPIOTE_POLARITY_TOGGLE, NRF_GPIOTE_INITIAL_VALUE_LOW);
+	nrf_gpiote_task_enable(NRF_GPIOTE, gpiote_ch);
+
+	if (nrfx_gppi_channel_alloc(&ppi_step_set) != NRFX_SUCCESS ||
+	    nrfx_gppi_channel_alloc(&ppi_step_clr) != NRFX_SUCCESS ||
+	    nrfx_gppi_channel_alloc(&ppi_move_done) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	// Timer compare -> rising edge of the step pulse
+	nrfx_gppi_channel_endpoints_setup(ppi_step_set,
+		nrf_timer_event_address_get(step_timer, nrf_timer_compare_event_get(step_interval_cc)),
+		nrf_gpiote_task_address_get(NRF_GPIOTE, nrf_gpiote_set_task_get(gpiote_ch)));
+
+	// End of the pulse -> falling edge, and count the step
+	nrfx_gppi_channel_endpoints_setup(ppi_step_clr,
+		nrf_timer_event_address_get(step_timer, nrf_timer_compare_event_get(step_pulse_cc)),
+		nrf_gpiote_task_address_get(NRF_GPIOTE, nrf_gpiote_clr_task_get(gpiote_ch)));
+	nrfx_gppi_fork_endpoint_setup(ppi_step_clr,
+		nrf_timer_task_address_get(count_timer, NRF_TIMER_TASK_COUNT));
+
+	// All steps counted -> stop generating pulses
+	nrfx_gppi_channel_endpoints_setup(ppi_move_done,
+		nrf_timer_event_address_get(count_timer, nrf_timer_compare_event_get(count_done_cc)),
+		nrf_timer_task_address_get(step_timer, NRF_TIMER_TASK_STOP));
+
+	return 0;
+}
+
+uint32_t stepper_backend_stop_task(void)
+{
+	return nrf_timer_task_address_get(step_timer, NRF_TIMER_TASK_STOP);
+}
+
+uint32_t stepper_backend_step_event(void)
+{
+	return nrf_timer_event_address_get(step_timer,
+					   nrf_timer_compare_event_get(step_interval_cc));
+}
+
+void stepper_backend_abort(void)
+{
+	nrf_timer_task_trigger(step_timer, NRF_TIMER_TASK_STOP);
+	nrf_timer_task_trigger(count_timer, NRF_TIMER_TASK_STOP);
+	nrf_timer_int_disable(step_timer, nrf_timer_compare_int_get(step_interval_cc));
+	nrfx_gppi_channels_disable(BIT(ppi_step_set) | BIT(ppi_step_clr) | BIT(ppi_move_done));
+
+	nrf_timer_task_trigger(step_timer, nrf_timer_capture_task_get(step_now_cc));
+	nrf_timer_task_trigger(count_timer, nrf_timer_capture_task_get(count_now_cc));
+
+	uint32_t steps = nrf_timer_cc_get(count_timer, count_now_cc);
+
+	/* A pulse that was cut short still made the driver take its step. */
+	if (nrf_timer_cc_get(step_timer, step_now_cc) < stepper_pulse_width) {
+		nrf_gpiote_task_trigger(NRF_GPIOTE, nrf_gpiote_clr_task_get(gpiote_ch));
+		steps++;
+	}
+
+	stepper_backend_done(steps);
+}
+
+void stepper_backend_decelerate(uint32_t from_step)
+{
+	ARG_UNUSED(from_step);
+
+	/* The step interrupt reads the shortened move from here on. Compares
+	 * that were already passed just do not fire anymore.
+	 */
+	nrf_timer_cc_set(count_timer, count_done_cc, move->steps);
+	nrf_timer_cc_set(count_timer, count_decel_cc, move->steps - 1 - move->ramp_steps);
+	/* Same as in count_timer_isr(), drop the compare of the step that
+	 * passed while cruising.
+	 */
+	nrf_timer_event_clear(step_timer, nrf_timer_compare_event_get(step_interval_cc));
+	nrf_timer_int_enable(step_timer, nrf_timer_compare_int_get(step_interval_cc));
+}
+
+uint32_t stepper_backend_steps(void)
+{
+	/* Own capture register, the step interrupt may preempt us at any time. */
+	nrf_timer_task_trigger(count_timer, nrf_timer_capture_task_get(count_progress_cc));
+
+	return nrf_timer_cc_get(count_timer, count_progress_cc);
+}
+
+int stepper_backend_init(void)
+{
+	step_timer_init();
+
+	return step_ppi_init();
+}
+
+void stepper_backend_start(const struct planner_move *m)
+{
+	uint32_t steps = m->steps;
+
+	move = m;
+
+	nrf_timer_task_trigger(step_timer, NRF_TIMER_TASK_CLEAR);
+	nrf_timer_task_trigger(count_timer, NRF_TIMER_TASK_CLEAR);
+	nrf_timer_cc_set(step_timer, step_interval_cc, planner_interval(move, 0));
+	nrf_timer_cc_set(count_timer, count_done_cc, steps);
+
+	/* Re-enable the step interrupt right before the step that starts the
+	 * deceleration. Without a ramp the interval never changes and the
+	 * interrupt is not needed at all.
+	 */
+	nrf_timer_cc_set(count_timer, count_decel_cc,
+			 move->ramp_steps ? steps - 1 - move->ramp_steps : steps);
+	nrf_timer_event_clear(step_timer, nrf_timer_compare_event_get(step_interval_cc));
+	nrf_timer_event_clear(count_timer, nrf_timer_compare_event_get(count_decel_cc));
+	if (move->ramp_steps) {
+		nrf_timer_int_enable(step_timer, nrf_timer_compare_int_get(step_interval_cc));
+	}
+
+	nrfx_gppi_channels_enable(BIT(ppi_step_set) | BIT(ppi_step_clr) | BIT(ppi_move_done));
+
+	// Run the motors, the first step starts right away
+	nrf_timer_task_trigger(count_timer, NRF_TIMER_TASK_START);
+	nrf_gpiote_task_trigger(NRF_GPIOTE, nrf_gpiote_set_task_get(gpiote_ch));
+	nrf_timer_task_trigger(step_timer, NRF_TIMER_TASK_START);
+}
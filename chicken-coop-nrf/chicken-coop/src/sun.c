@@ -0,0 +1,171 @@
+#include "sun.h"
+
+#include <errno.h>
+#include <stdbool.h>
+
+/* Angles are binary angles, a full turn is 2^32 and wraps around for free.
+ * Sines and cosines are Q15.
+ */
+#define ANGLE_DEG(deg) ((uint32_t)((deg) * 11930464.7111))
+#define Q15_ONE 32768
+
+#define SECONDS_PER_DAY 86400
+
+/* 2000-01-01 12:00 UTC, the J2000 epoch, as Unix time and as day. */
+#define J2000_UNIX 946728000LL
+#define J2000_DAY 10957
+
+/* Terrestrial time runs ahead of UTC, 0.0008 days in the sunrise equation. */
+#define TT_OFFSET_S 69
+
+/* Mean anomaly at J2000 and its rate, 0.98560028 deg per day, in Q16 per second. */
+#define MEAN_ANOMALY_J2000 ANGLE_DEG(357.5291)
+#define MEAN_ANOMALY_RATE_Q16 8919168LL
+
+/* Equation of center coefficients. */
+#define CENTER_1 ANGLE_DEG(1.9148)
+#define CENTER_2 ANGLE_DEG(0.0200)
+#define CENTER_3 ANGLE_DEG(0.0003)
+
+/* Argument of perihelion plus 180 degrees. */
+#define ECLIPTIC_OFFSET ANGLE_DEG(282.9372)
+
+/* Equation of time coefficients, 0.0053 and 0.0069 days. */
+#define EQ_TIME_ANOMALY_S 458
+#define EQ_TIME_ECLIPTIC_S 596
+
+/* Sine of the obliquity of the ecliptic, 23.4397 deg. */
+#define SIN_OBLIQUITY 13035
+
+/* Sine of -0.833 deg, the sun center altitude at sunrise with refraction. */
+#define SIN_HORIZON (-476)
+
+/* Quarter sine wave, interpolated linearly in between. */
+static const int16_t sine_table[65] = {
+	0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512,
+	10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+	18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279,
+	24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268,
+	29621, 29956, 30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137,
+	32285, 32412, 32521, 32609, 32678, 32728, 32757, 32767,
+};
+
+static int32_t sin_q15(uint32_t angle)
+{
+	uint32_t quadrant = angle >> 30;
+	uint32_t pos = angle & 0x3FFFFFFF;
+	int32_t value;
+
+	if (quadrant & 1) {
+		pos = 0x40000000 - pos;
+	}
+
+	uint32_t idx = pos >> 24;
+	int32_t frac = (pos >> 8) & 0xFFFF;
+
+	if (idx >= 64) {
+		value = sine_table[64];
+	} else {
+		value = sine_table[idx] +
+			(((sine_table[idx + 1] - sine_table[idx]) * frac) >> 16);
+	}
+
+	return (quadrant & 2) ? -value : value;
+}
+
+static int32_t cos_q15(uint32_t angle)
+{
+	return sin_q15(angle + 0x40000000);
+}
+
+/* Angle in [0, half turn] whose cosine is c. */
+static uint32_t acos_angle(int32_t c)
+{
+	uint32_t lo = 0;
+	uint32_t hi = 0x80000000;
+
+	/* The cosine decreases over the half turn, bisect down to ~0.0003 deg. */
+	while (hi - lo > (1 << 12)) {
+		uint32_t mid = lo + (hi - lo) / 2;
+
+		if (cos_q15(mid) > c) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static uint32_t isqrt(uint32_t x)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1U << 30;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+
+	while (bit) {
+		if (x >= root + bit) {
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+int sun_times(int32_t day, int16_t latitude, int16_t longitude, int64_t *sunrise,
+	      int64_t *sunset)
+{
+	/* Mean solar noon at this longitude, in seconds since J2000. A hundredth
+	 * of a degree of longitude is 2.4 s.
+	 */
+	int64_t noon = (int64_t)(day - J2000_DAY) * SECONDS_PER_DAY -
+		       (int64_t)longitude * 12 / 5 + TT_OFFSET_S;
+
+	uint32_t anomaly = MEAN_ANOMALY_J2000 + (uint32_t)((noon * MEAN_ANOMALY_RATE_Q16) >> 16);
+	int32_t sin_anomaly = sin_q15(anomaly);
+	int64_t center = (int64_t)CENTER_1 * sin_anomaly +
+			 (int64_t)CENTER_2 * sin_q15(2 * anomaly) +
+			 (int64_t)CENTER_3 * sin_q15(3 * anomaly);
+	uint32_t ecliptic = anomaly + (uint32_t)(int32_t)(center / Q15_ONE) + ECLIPTIC_OFFSET;
+
+	int64_t transit = J2000_UNIX + noon +
+			  ((int64_t)EQ_TIME_ANOMALY_S * sin_anomaly -
+			   (int64_t)EQ_TIME_ECLIPTIC_S * sin_q15(2 * ecliptic)) / Q15_ONE;
+
+	/* Declination of the sun. */
+	int32_t sin_decl = sin_q15(ecliptic) * SIN_OBLIQUITY / Q15_ONE;
+	int32_t cos_decl = isqrt((1U << 30) - sin_decl * sin_decl);
+
+	uint32_t lat = (uint32_t)(((int64_t)latitude << 32) / 36000);
+	int32_t sin_lat = sin_q15(lat);
+	int32_t cos_lat = cos_q15(lat);
+
+	/* Hour angle between transit and sunrise, Q30 before the division. */
+	int64_t num = (int64_t)SIN_HORIZON * Q15_ONE - (int64_t)sin_lat * sin_decl;
+	int64_t den = (int64_t)cos_lat * cos_decl;
+
+	if (den <= 0) {
+		return -ENOENT;
+	}
+
+	int64_t cos_hour = num * Q15_ONE / den;
+
+	if (cos_hour >= Q15_ONE || cos_hour <= -Q15_ONE) {
+		return -ENOENT;
+	}
+
+	int64_t half_day = ((uint64_t)acos_angle(cos_hour) * SECONDS_PER_DAY) >> 32;
+
+	*sunrise = transit - half_day;
+	*sunset = transit + half_day;
+
+	return 0;
+}
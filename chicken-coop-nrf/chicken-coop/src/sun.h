@@ -0,0 +1,24 @@
+#ifndef SUN_H
+#define SUN_H
+
+#include <stdint.h>
+
+/**@brief Compute sunrise and sunset of a day.
+ *
+ * Integer only implementation of the sunrise equation, including the equation
+ * of center, equation of time and atmospheric refraction. Accurate to about a
+ * minute away from the polar circles.
+ *
+ * @param[in]   day         UTC day, counted in days since 1970-01-01.
+ * @param[in]   latitude    Latitude [0.01 deg], north positive.
+ * @param[in]   longitude   Longitude [0.01 deg], east positive.
+ * @param[out]  sunrise     Sunrise as Unix time [s].
+ * @param[out]  sunset      Sunset as Unix time [s].
+ *
+ * @retval 0        Sunrise and sunset computed.
+ * @retval -ENOENT  The sun does not rise or does not set on that day.
+ */
+int sun_times(int32_t day, int16_t latitude, int16_t longitude, int64_t *sunrise,
+	      int64_t *sunset);
+
+#endif
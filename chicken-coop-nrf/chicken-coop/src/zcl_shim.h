@@ -0,0 +1,59 @@
+#ifndef ZCL_SHIM_H
+#define ZCL_SHIM_H
+
+/* The few Zigbee stack services the door clusters of coop_zcl.c rely on.
+ * On the device zcl_shim_zboss.c passes them to ZBOSS. With
+ * CONFIG_CHICKEN_COOP_SIM zcl_shim_sim.c keeps the attributes in RAM and runs
+ * the scheduled callbacks from the system workqueue, and zcl_shim_sim.h
+ * declares the ZBOSS types and identifiers coop_zcl.c uses.
+ */
+
+#ifdef CONFIG_CHICKEN_COOP_SIM
+#include "zcl_shim_sim.h"
+#else
+#include <zboss_api.h>
+#include <zboss_api_addons.h>
+#endif
+
+#include "zb_zcl_coop_config.h"
+
+/* Device endpoint, used to receive light controlling commands. */
+#define CHICKEN_COOP_ENDPOINT         10
+
+/**@brief Set a server attribute of the coop endpoint, from the Zigbee thread.
+ *
+ * Reported to the bound clients as configured by zcl_shim_reporting_init().
+ *
+ * @param[in]   cluster_id   Cluster of the attribute.
+ * @param[in]   attr_id      Attribute identifier.
+ * @param[in]   manuf_code   Manufacturer code, ZB_ZCL_NON_MANUFACTURER_SPECIFIC for standard attributes.
+ * @param[in]   value        New value, in the size and byte order of the attribute.
+ */
+void zcl_shim_attr_set(zb_uint16_t cluster_id, zb_uint16_t attr_id, zb_uint16_t manuf_code,
+		       zb_uint8_t *value);
+
+/**@brief Run a callback in the Zigbee thread, from any thread.
+ *
+ * @param[in]   cb      Callback to run.
+ * @param[in]   param   Passed to the callback.
+ *
+ * @return RET_OK, or an error if the callback queue is full.
+ */
+zb_ret_t zcl_shim_schedule(zb_callback_t cb, zb_uint8_t param);
+
+/**@brief Set up the default reporting of a server attribute of the coop endpoint.
+ *
+ * @param[in]   cluster_id   Cluster of the attribute.
+ * @param[in]   attr_id      Attribute to report.
+ * @param[in]   manuf_code   Manufacturer code of the attribute.
+ */
+void zcl_shim_reporting_init(zb_uint16_t cluster_id, zb_uint16_t attr_id,
+			     zb_uint16_t manuf_code);
+
+/**@brief Send an alarm of the coop configuration cluster to the bound clients, from the Zigbee thread.
+ *
+ * @param[in]   alarm_code   See @ref zb_zcl_coop_config_alarm_e.
+ */
+void zcl_shim_alarm_send(zb_uint16_t alarm_code);
+
+#endif
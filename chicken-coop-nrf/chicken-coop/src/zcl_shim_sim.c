@@ -0,0 +1,146 @@
+#include "zcl_shim.h"
+#include "coop_zcl.h"
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(zcl_shim, LOG_LEVEL_INF);
+
+/* Callbacks waiting for the Zigbee thread, as deep as the ZBOSS callback queue. */
+#define SIM_CALLBACK_QUEUE 16
+
+struct sim_callback {
+	zb_callback_t cb;
+	zb_uint8_t param;
+};
+
+/* Attribute as the stack would find it through the attribute lists of main.c. */
+struct sim_attr {
+	zb_uint16_t cluster_id;
+	zb_uint16_t attr_id;
+	void *data;
+	size_t size;
+};
+
+#define SIM_ATTR(_cluster, _attr, _field)					\
+	{ _cluster, _attr, &coop_zcl_ctx._field, sizeof(coop_zcl_ctx._field) }
+
+#define SIM_COOP_ATTR(_attr, _field)						\
+	SIM_ATTR(ZB_ZCL_CLUSTER_ID_COOP_CONFIG, ZB_ZCL_ATTR_COOP_CONFIG_##_attr##_ID,	\
+		 coop_config_attr._field)
+
+static const struct sim_attr attrs[] = {
+	SIM_ATTR(ZB_ZCL_CLUSTER_ID_ON_OFF, ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID, on_off_attr.on_off),
+	SIM_ATTR(ZB_ZCL_CLUSTER_ID_WINDOW_COVERING,
+		 ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_LIFT_PERCENTAGE_ID,
+		 window_covering_attr.current_position_lift_percentage),
+	SIM_ATTR(ZB_ZCL_CLUSTER_ID_ILLUMINANCE_MEASUREMENT,
+		 ZB_ZCL_ATTR_ILLUMINANCE_MEASUREMENT_MEASURED_VALUE_ID,
+		 illuminance_attr.measured_value),
+	SIM_COOP_ATTR(TRAVEL_STEPS, travel_steps),
+	SIM_COOP_ATTR(CRUISE_SPEED, cruise_speed),
+	SIM_COOP_ATTR(ACCELERATION, acceleration),
+	SIM_COOP_ATTR(HOLD_TIMEOUT, hold_timeout),
+	SIM_COOP_ATTR(DOOR_STATE, door_state),
+	SIM_COOP_ATTR(POSITION_ERROR, position_error),
+	SIM_COOP_ATTR(SCHEDULE_ENABLED, schedule_enabled),
+	SIM_COOP_ATTR(LATITUDE, latitude),
+	SIM_COOP_ATTR(LONGITUDE, longitude),
+	SIM_COOP_ATTR(SUNRISE_OFFSET, sunrise_offset),
+	SIM_COOP_ATTR(SUNSET_OFFSET, sunset_offset),
+	SIM_COOP_ATTR(LIGHT_CONTROL, light_control),
+	SIM_COOP_ATTR(DAWN_LEVEL, dawn_level),
+	SIM_COOP_ATTR(DUSK_LEVEL, dusk_level),
+};
+
+K_MSGQ_DEFINE(callback_queue, sizeof(struct sim_callback), SIM_CALLBACK_QUEUE, 4);
+K_MUTEX_DEFINE(zigbee_lock);
+
+static atomic_t alarms;
+
+static void callback_work_handler(struct k_work *work)
+{
+	struct sim_callback callback;
+
+	ARG_UNUSED(work);
+
+	while (!k_msgq_get(&callback_queue, &callback, K_NO_WAIT)) {
+		zcl_shim_sim_lock();
+		callback.cb(callback.param);
+		zcl_shim_sim_unlock();
+	}
+}
+
+static K_WORK_DEFINE(callback_work, callback_work_handler);
+
+void zcl_shim_sim_lock(void)
+{
+	k_mutex_lock(&zigbee_lock, K_FOREVER);
+}
+
+void zcl_shim_sim_unlock(void)
+{
+	k_mutex_unlock(&zigbee_lock);
+}
+
+zb_uint32_t zcl_shim_sim_alarms(void)
+{
+	return atomic_get(&alarms);
+}
+
+void zcl_shim_attr_set(zb_uint16_t cluster_id, zb_uint16_t attr_id, zb_uint16_t manuf_code,
+		       zb_uint8_t *value)
+{
+	bool manuf_specific = manuf_code != ZB_ZCL_NON_MANUFACTURER_SPECIFIC;
+
+	for (size_t i = 0; i < ARRAY_SIZE(attrs); i++) {
+		const struct sim_attr *attr = &attrs[i];
+		uint32_t raw = 0;
+
+		/* Like ZBOSS, the manufacturer code has to match the attribute. */
+		if (attr->cluster_id != cluster_id || attr->attr_id != attr_id ||
+		    manuf_specific != (cluster_id == ZB_ZCL_CLUSTER_ID_COOP_CONFIG)) {
+			continue;
+		}
+
+		memcpy(attr->data, value, attr->size);
+		memcpy(&raw, value, attr->size);
+
+		LOG_INF("Attribute 0x%04x/0x%04x set to %u", cluster_id, attr_id, raw);
+		return;
+	}
+
+	LOG_ERR("No attribute 0x%04x/0x%04x", cluster_id, attr_id);
+}
+
+zb_ret_t zcl_shim_schedule(zb_callback_t cb, zb_uint8_t param)
+{
+	struct sim_callback callback = {
+		.cb = cb,
+		.param = param,
+	};
+
+	if (k_msgq_put(&callback_queue, &callback, K_NO_WAIT)) {
+		return RET_ERROR;
+	}
+
+	k_work_submit(&callback_work);
+
+	return RET_OK;
+}
+
+void zcl_shim_reporting_init(zb_uint16_t cluster_id, zb_uint16_t attr_id,
+			     zb_uint16_t manuf_code)
+{
+	/* Nobody is bound, every change is already logged by zcl_shim_attr_set(). */
+	LOG_DBG("Reporting 0x%04x/0x%04x, manufacturer 0x%04x", cluster_id, attr_id,
+		manuf_code);
+}
+
+void zcl_shim_alarm_send(zb_uint16_t alarm_code)
+{
+	atomic_inc(&alarms);
+
+	LOG_WRN("Alarm 0x%02x", alarm_code);
+}
@@ -0,0 +1,98 @@
+#ifndef ZCL_SHIM_SIM_H
+#define ZCL_SHIM_SIM_H
+
+/* The part of the ZBOSS API used by coop_zcl.c, for the native_sim build.
+ * Names and identifiers are those of ZBOSS, return codes only need to be
+ * told apart. Included through zcl_shim.h only.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t zb_uint8_t;
+typedef int16_t zb_int16_t;
+typedef uint16_t zb_uint16_t;
+typedef int32_t zb_int32_t;
+typedef uint32_t zb_uint32_t;
+typedef zb_uint8_t zb_bool_t;
+typedef zb_int32_t zb_ret_t;
+typedef zb_uint8_t zb_bufid_t;
+
+typedef void (*zb_callback_t)(zb_uint8_t param);
+
+#define ZB_FALSE 0U
+#define ZB_TRUE 1U
+
+#define ZVUNUSED(v) ((void)(v))
+
+#define RET_OK 0
+#define RET_ERROR (-1)
+#define RET_INVALID_PARAMETER_1 (-2)
+#define RET_NOT_IMPLEMENTED (-3)
+
+#define ZB_ZCL_NON_MANUFACTURER_SPECIFIC 0xFFFFU
+
+#define ZB_ZCL_CLUSTER_ID_ON_OFF 0x0006U
+#define ZB_ZCL_CLUSTER_ID_WINDOW_COVERING 0x0102U
+#define ZB_ZCL_CLUSTER_ID_ILLUMINANCE_MEASUREMENT 0x0400U
+
+#define ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID 0x0000U
+#define ZB_ZCL_ATTR_WINDOW_COVERING_CURRENT_POSITION_LIFT_PERCENTAGE_ID 0x0008U
+#define ZB_ZCL_ATTR_ILLUMINANCE_MEASUREMENT_MEASURED_VALUE_ID 0x0000U
+
+/* Bits of the Window Covering Config/Status attribute. */
+#define ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_OPERATIONAL 0x01U
+#define ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_ONLINE 0x02U
+#define ZB_ZCL_ATTR_WINDOW_COVERING_CONFIG_LIFT_CONTROL_IS_CLOSED_LOOP 0x08U
+
+/* Device callbacks handled by coop_zcl_device_cb(). */
+enum zb_zcl_device_callback_id_e {
+	ZB_ZCL_SET_ATTR_VALUE_CB_ID,
+	ZB_ZCL_WINDOW_COVERING_UP_OPEN_CB_ID,
+	ZB_ZCL_WINDOW_COVERING_DOWN_CLOSE_CB_ID,
+	ZB_ZCL_WINDOW_COVERING_STOP_CB_ID,
+	ZB_ZCL_WINDOW_COVERING_GO_TO_LIFT_PERCENTAGE_CB_ID,
+};
+
+typedef struct {
+	zb_bool_t on_off;
+} zb_zcl_on_off_attrs_t;
+
+typedef struct {
+	zb_uint16_t cluster_id;
+	zb_uint16_t attr_id;
+	union {
+		zb_uint8_t data8;
+		zb_uint16_t data16;
+		zb_uint32_t data32;
+	} values;
+} zb_zcl_set_attr_value_param_t;
+
+typedef struct {
+	zb_uint8_t percentage_lift_value;
+} zb_zcl_go_to_lift_percentage_req_t;
+
+typedef struct {
+	enum zb_zcl_device_callback_id_e device_cb_id;
+	zb_uint8_t endpoint;
+	union {
+		zb_zcl_set_attr_value_param_t set_attr_value_param;
+		zb_zcl_go_to_lift_percentage_req_t go_to_lift_percentage;
+	} cb_param;
+	zb_ret_t status;
+} zb_zcl_device_callback_param_t;
+
+/**@brief Serialize with the callbacks of zcl_shim_schedule().
+ *
+ * The shell thread holds it while feeding a ZCL command, the system
+ * workqueue while running a scheduled callback, as if both were the
+ * Zigbee thread.
+ */
+void zcl_shim_sim_lock(void);
+
+void zcl_shim_sim_unlock(void);
+
+/**@brief Alarms sent since boot. */
+zb_uint32_t zcl_shim_sim_alarms(void);
+
+#endif
@@ -0,0 +1,89 @@
+#include "zcl_shim.h"
+
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zigbee/zigbee_app_utils.h>
+
+LOG_MODULE_REGISTER(zcl_shim, LOG_LEVEL_INF);
+
+void zcl_shim_attr_set(zb_uint16_t cluster_id, zb_uint16_t attr_id, zb_uint16_t manuf_code,
+		       zb_uint8_t *value)
+{
+	if (manuf_code == ZB_ZCL_NON_MANUFACTURER_SPECIFIC) {
+		ZB_ZCL_SET_ATTRIBUTE(
+			CHICKEN_COOP_ENDPOINT,
+			cluster_id,
+			ZB_ZCL_CLUSTER_SERVER_ROLE,
+			attr_id,
+			value,
+			ZB_FALSE);
+		return;
+	}
+
+	zb_zcl_set_attr_val_manuf(
+		CHICKEN_COOP_ENDPOINT,
+		cluster_id,
+		ZB_ZCL_CLUSTER_SERVER_ROLE,
+		attr_id,
+		manuf_code,
+		value,
+		ZB_FALSE);
+}
+
+zb_ret_t zcl_shim_schedule(zb_callback_t cb, zb_uint8_t param)
+{
+	return zigbee_schedule_callback(cb, param);
+}
+
+void zcl_shim_reporting_init(zb_uint16_t cluster_id, zb_uint16_t attr_id,
+			     zb_uint16_t manuf_code)
+{
+	zb_zcl_reporting_info_t rep_info;
+	zb_ret_t zb_err_code;
+
+	memset(&rep_info, 0, sizeof(rep_info));
+	rep_info.direction = ZB_ZCL_CONFIGURE_REPORTING_SEND_REPORT;
+	rep_info.ep = CHICKEN_COOP_ENDPOINT;
+	rep_info.cluster_id = cluster_id;
+	rep_info.cluster_role = ZB_ZCL_CLUSTER_SERVER_ROLE;
+	rep_info.attr_id = attr_id;
+	rep_info.manuf_code = manuf_code;
+	rep_info.dst.profile_id = ZB_AF_HA_PROFILE_ID;
+	rep_info.u.send_info.min_interval = CONFIG_CHICKEN_COOP_REPORT_MIN_INTERVAL;
+	rep_info.u.send_info.max_interval = CONFIG_CHICKEN_COOP_REPORT_MAX_INTERVAL;
+	rep_info.u.send_info.def_min_interval = CONFIG_CHICKEN_COOP_REPORT_MIN_INTERVAL;
+	rep_info.u.send_info.def_max_interval = CONFIG_CHICKEN_COOP_REPORT_MAX_INTERVAL;
+	/* Any change is reportable, the motion thread already thins out
+	 * the position updates during a move.
+	 */
+	rep_info.u.send_info.delta.u8 = 0;
+
+	zb_err_code = zb_zcl_put_reporting_info(&rep_info, ZB_TRUE);
+	if (zb_err_code != RET_OK) {
+		LOG_ERR("Cannot configure reporting of attribute %hd (err: %d)",
+			attr_id, zb_err_code);
+	}
+}
+
+/**@brief Function for sending an alarm to the bound clients.
+ *
+ * @param[in]   bufid        Buffer to send the alarm with.
+ * @param[in]   alarm_code   See @ref zb_zcl_coop_config_alarm_e.
+ */
+static void alarm_send(zb_bufid_t bufid, zb_uint16_t alarm_code)
+{
+	zb_addr_u addr = { 0 };
+
+	ZB_ZCL_ALARMS_SEND_ALARM_RES(bufid, addr, ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT,
+				     0, CHICKEN_COOP_ENDPOINT, ZB_AF_HA_PROFILE_ID, NULL,
+				     alarm_code, ZB_ZCL_CLUSTER_ID_COOP_CONFIG);
+}
+
+void zcl_shim_alarm_send(zb_uint16_t alarm_code)
+{
+	zb_ret_t zb_err_code = zb_buf_get_out_delayed_ext(alarm_send, alarm_code, 0);
+
+	if (zb_err_code != RET_OK) {
+		LOG_WRN("Cannot send alarm (err: %d)", zb_err_code);
+	}
+}